@@ -344,8 +344,16 @@ scrib::Face_Vector_Format * ofApp::processUsingFaceFinder()
 
 scrib::Face_Vector_Format * ofApp::processUsingGraphEmbedder()
 {
-	scrib::Graph * graph      = polyline_embedder.embedPolyline(&points);
-    post_processor.freeGraph();
+	// Embeds into the previous graph, if there is one, so that its storage is reused.
+	scrib::Graph * graph      = polyline_embedder.embedPolyline(&points, post_processor.getGraph());
+
+	// The scribble is too large to embed, the previous graph is kept and still loaded.
+	if (graph == NULL)
+	{
+		cout << "Scribble Too Large For PolylineGraphEmbedder" << endl;
+		return new scrib::Face_Vector_Format();
+	}
+
 	post_processor.load_graph(graph);
 	scrib::Face_Vector_Format * face_vector = post_processor.convert_to_face_vectors();
 	
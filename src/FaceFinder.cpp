@@ -30,6 +30,13 @@ namespace scrib {
         // Make sure that the previous data is cleared.
         loadInput(inputs);
 
+        // Every point was identical.
+        if (lines_initial.empty())
+        {
+            cleanup();
+            return trivial(inputs);
+        }
+
         return do_the_rest();
     }
 
@@ -65,6 +72,103 @@ namespace scrib {
         return output;
     }
 
+    Topology_Summary FaceFinder::summarizeTopology(std::vector<ofPoint> * inputs)
+    {
+        loadInput(inputs);
+        return summarize_the_rest();
+    }
+
+    Topology_Summary FaceFinder::summarizeTopology(std::vector< std::vector<ofPoint> *> * inputs)
+    {
+        int len = inputs->size();
+        for (int i = 0; i < len; i++)
+        {
+            loadInput(inputs->at(i));
+        }
+
+        return summarize_the_rest();
+    }
+
+    // Returns the representative of the set containing the given element, halving the path along the way.
+    static inline int find_root(std::vector<int> & parents, int element)
+    {
+        while (parents[element] != element)
+        {
+            parents[element] = parents[parents[element]];
+            element = parents[element];
+        }
+
+        return element;
+    }
+
+    inline Topology_Summary FaceFinder::summarize_the_rest()
+    {
+        // Crossing points are appended after the input points and every point is merged with its copies,
+        // so the crossings are the vertices beyond the distinct input points.
+        std::vector< std::pair<float, float> > input_points;
+        int numPoints = points.size();
+        for (int i = 0; i < numPoints; i++)
+        {
+            input_points.push_back(std::make_pair(points[i].x, points[i].y));
+        }
+
+        std::sort(input_points.begin(), input_points.end());
+        int numInputs = std::unique(input_points.begin(), input_points.end()) - input_points.begin();
+
+        splitIntersectionPoints();
+
+        Topology_Summary summary;
+        summary.vertices  = points.size();
+        summary.edges     = lines_split.size();
+        summary.crossings = summary.vertices - numInputs;
+
+        // Union find over the vertices, joined along every line.
+        std::vector<int> parents(summary.vertices);
+        for (int i = 0; i < summary.vertices; i++)
+        {
+            parents[i] = i;
+        }
+
+        summary.components = summary.vertices;
+
+        for (int i = 0; i < summary.edges; i++)
+        {
+            int root_a = find_root(parents, lines_split.i1[i]);
+            int root_b = find_root(parents, lines_split.i2[i]);
+
+            if (root_a != root_b)
+            {
+                parents[root_a] = root_b;
+                summary.components--;
+            }
+        }
+
+        summary.faces = summary.edges - summary.vertices + summary.components + 1;
+
+        cleanup();
+
+        return summary;
+    }
+
+    bool FaceFinder::isSimple(std::vector<ofPoint> * inputs)
+    {
+        loadInput(inputs);
+
+        // An input that ends where it started is closed by its last line, which joins the first point.
+        int last = points.size() - 1;
+        if (last > 0 && points[last].x == points[0].x && points[last].y == points[0].y)
+        {
+            lines_initial.i2.back() = 0;
+        }
+
+        scrib::Intersector intersector;
+        bool simple = intersector.isSimple(&lines_initial);
+
+        cleanup();
+
+        return simple;
+    }
+
     void FaceFinder::loadInput(std::vector<ofPoint> * inputs)
     {
         // Populate the original points.
@@ -72,66 +176,63 @@ namespace scrib {
 
         // The offset is the initial index of the first input point.
         // We can therefore load multiple input lines and keep the indices distinct.
+        // Identical points that are not consecutive are merged after the intersection points have been found.
         int offset = points.size();
 
         for (int i = 0; i < len; i++)
         {
-            ofPoint input_point = inputs->at(i) + ofPoint(ofRandomf(), ofRandomf());
+            ofPoint input_point = inputs->at(i);
 
-            // A Paranoid vertical line prevention technique.
-            if ((offset > 0 || i > 0) && points[offset + i - 1].x == input_point.x)
+            // Repeated points would form lines of length 0.
+            // The intersection predicates are exact, so the points do not need to be perturbed.
+            if (points.size() > (size_t)offset && points.back().x == input_point.x && points.back().y == input_point.y)
             {
-                input_point.x += .001;
+                continue;
             }
 
             points.push_back(input_point);
         }
 
+        int last = points.size() - 1;
+
         // Populate the original lines.
-        for (int i = 0; i < len - 1; i++)
+        for (int i = offset; i < last; i++)
         {
-            lines_initial.push_back(scrib::Line(i + offset, i + offset + 1, &points));
+            lines_initial.push_back(i, i + 1);
         }
 
         // Add a line connecting the first and last points on the original set of input points if
-        // the face finder is in closed loop mode.
-        // In other words put a duplicate copy of the initial point.
-        if (closed_loop)
+        // the face finder is in closed loop mode, unless the input already ends where it started.
+        if (closed_loop && last > offset && !(points[last].x == points[offset].x && points[last].y == points[offset].y))
         {
-            // connects last point at index (len - 1 + offset) to the first point, located at index (0 + offset).
-            lines_initial.push_back(scrib::Line(len - 1 + offset, 0 + offset, &points));
+            // connects last point at index last to the first point, located at index offset.
+            lines_initial.push_back(last, offset);
         }
-
     }
 
     void FaceFinder::splitIntersectionPoints()
     {
 
         scrib::Intersector intersector;
+        intersector.setNumThreads(num_threads);
 
-        // Use a custom made O(maximum vertical overlap * log(maximum vertical overlap).
-        // Very small constant factors, cache friendly.
-        if (bUseFastAlgo)
-        {
-            intersector.intersect(&lines_initial);
-        }
-        else
-        {
-            // Naive brute force algo.
-            // N^2. Small constants. As robust as it gets.
-            intersector.intersect_brute_force(&lines_initial);
-        }
+        // Every split point found is recorded in one shared buffer.
+        scrib::SplitBuffer splits;
+        splits.attach(&lines_initial);
+
+        // Uses the Bentley-Ottmann sweep line unless another Intersection_Algorithm was requested.
+        intersector.intersect(&lines_initial, algorithm);
 
         // Populate the split sequence of lines.
         lines_split.clear();
 
-        int numLines = lines_initial.size();
+        // Populates the list of edge disjoint lines that only intersect at vertices.
+        // puts the edge in consecutive order following the input polylines.
+        splits.getSplitLines(lines_initial, &lines_split);
 
-        for (int i = 0; i < numLines; i++)
-        {
-            scrib::Line line = lines_initial[i];
-            line.getSplitLines(&lines_split);
-        }
+        // Lines crossing at a shared point each create a copy of it.
+        // Collinear overlapping lines and repeated input lines become identical lines after splitting.
+        mergeCoincidentPoints(&points, &lines_split);
     }
 
     void FaceFinder::convert_to_directedGraph()
@@ -151,10 +252,8 @@ namespace scrib {
         int numLines = lines_split.size();
         for (int i = 0; i < numLines; i++)
         {
-            scrib::Line * line = &(lines_split[i]);
-
-            int index_a = line->p1_index;
-            int index_b = line->p2_index;
+            int index_a = lines_split.i1[i];
+            int index_b = lines_split.i2[i];
 
             // Add both directions.
             addDirectedEdge(index_a, index_b);
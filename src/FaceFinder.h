@@ -9,18 +9,40 @@
 * 8/16/2016: Rewrote as PlanarGraphEmbedder in order to output full graph embeddings using a half edge structure.
 *            This class remains as a very focused class.
 * 8/18/2016: Post proccessing operations have been moved to PolylineGraphEmbedder
+* 10/17/2026: Added topology summaries and simple polyline queries, which only run the intersection phase.
 *
 * Written for the STUDIO for Creative Inquiry at Carnegie Mellon University.
 */
 
 #include <vector>
 #include "ofMain.h"
-#include "Line.h"
+#include "Segments.h"
 #include "Intersector.h"
 #include "PolylineGraphPostProcessor.h" // point_info definition.
 
 namespace scrib {
 
+    // Sizes of the planar embedding that FindFaces would trace, found without tracing any faces.
+    struct Topology_Summary
+    {
+        // Distinct points, including the crossing points.
+        int vertices;
+
+        // Lines between the vertices, once the input lines have been split at every crossing and overlaps have been merged.
+        int edges;
+
+        // Faces of the embedding, including the one unbounded face, by Euler's formula V - E + F = 1 + C.
+        // FindFaces traces the unbounded face once for every component, so it outputs faces + components - 1 cycles.
+        // Lines doubling back over the line that they continue from are not split at each other,
+        // so the formula only holds for input that never doubles back.
+        int faces;
+
+        // Connected components.
+        int components;
+
+        // Vertices created where lines cross, other than at input points.
+        int crossings;
+    };
 
     class FaceFinder
     {
@@ -31,8 +53,21 @@ namespace scrib {
         // but it kills the performance.
         FaceFinder(bool useFastAlgo = true)
         {
-            bUseFastAlgo = useFastAlgo;
+            algorithm = useFastAlgo ? SWEEP_LINE : BRUTE_FORCE;
+            closed_loop = false;
+            num_threads = 0;
+            lines_initial.points = &points;
+            lines_split.points = &points;
+        };
+
+        // Finds the intersection points using the given algorithm.
+        FaceFinder(Intersection_Algorithm algorithm)
+        {
+            this -> algorithm = algorithm;
             closed_loop = false;
+            num_threads = 0;
+            lines_initial.points = &points;
+            lines_split.points = &points;
         };
         virtual ~FaceFinder() {};
 
@@ -68,8 +103,8 @@ namespace scrib {
         // Derive faces from a single polyline input.
         // No guarantee is made about the order of the polygons.
         // The Output is a list of sub polygons.
-        // All of the points given as inputs to this algorithm will be treated as if they were distinct.
-        // The points will also be randomly offset by a 'small' amount to prevent the existence of vertical lines.
+        // Identical input points are treated as the same point.
+        // Vertical, collinear and touching lines are handled exactly, so the points are used as is.
         /*std::vector< // List of Polygons.
             std::vector< // Each polygon is a list of points.
             point_info // Information about the point.
@@ -85,10 +120,27 @@ namespace scrib {
          */
         Face_Vector_Format * FindFaces(std::vector< std::vector<ofPoint> *> * inputs);
 
+        // Counts the vertices, edges, faces and components that FindFaces would produce for the same input.
+        // Only the lines are intersected, no directed graph is built and no faces are traced.
+        Topology_Summary summarizeTopology(std::vector<ofPoint> * inputs);
+        Topology_Summary summarizeTopology(std::vector< std::vector<ofPoint> *> * inputs);
+
+        // Returns true iff the input polyline never meets itself, other than consecutive lines at their common point.
+        // In closed mode the closing line is included, and an input that ends where it started is a simple closed curve.
+        // Stops at the first self intersection, so pathological input is rejected quickly.
+        bool isSimple(std::vector<ofPoint> * inputs);
+
         // Tells this face finder to interpret the input curve as a line if open and a closed loop if closed.
         // If close, it will consider endpoints as attached to each other.
         void setClosed(bool isClosed);
 
+        // Sets the number of threads used by the PARALLEL_SWEEP_LINE algorithm.
+        // 0, the default, uses every hardware thread.
+        void setNumThreads(int num_threads)
+        {
+            this -> num_threads = num_threads;
+        }
+
 
     protected:
     private:
@@ -96,9 +148,11 @@ namespace scrib {
         // The trivial function constructs the proper output for input polylines of size 1 or 0.
         inline Face_Vector_Format * trivial(std::vector<ofPoint> * inputs);
         inline Face_Vector_Format * do_the_rest();
+        inline Topology_Summary summarize_the_rest();
 
-        bool bUseFastAlgo;
+        Intersection_Algorithm algorithm;
         bool closed_loop;
+        int num_threads;
 
         // Initializes the original lines from the input points.
         // Starts up the indexed collection of points.
@@ -154,9 +208,9 @@ namespace scrib {
         std::vector<ofPoint> points;
 
         // The original input lines.
-        std::vector<scrib::Line> lines_initial;
+        scrib::SegmentSoA lines_initial;
         // Split version of original input lines, where lines only intersect at vertices.
-        std::vector<scrib::Line> lines_split;
+        scrib::SegmentSoA lines_split;
 
         // The directed graph that represents edges between points.
         // Each of the integers represents an index into the points array.
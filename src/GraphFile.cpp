@@ -0,0 +1,436 @@
+/*
+*  GraphFile.cpp
+*
+*  Written on 10/17/2026.
+*
+*/
+
+#include "GraphFile.h"
+#include <stdio.h>
+#include <string.h>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace scrib
+{
+
+    static const char GRAPH_FILE_MAGIC[8] = {'S', 'C', 'R', 'I', 'B', 'G', 'R', 'F'};
+
+    // Written as is, so a file written on a machine of the other byte order reads as 0x04030201.
+    static const uint32_t GRAPH_FILE_BYTE_ORDER = 0x01020304;
+
+    // The order of the element arrays within the file.
+    enum Graph_File_Section
+    {
+        VERTICES = 0, EDGES = 1, HALFEDGES = 2, FACES = 3, NUM_SECTIONS = 4
+    };
+
+    struct Graph_File_Header
+    {
+        char     magic[8];
+        uint32_t version;
+        uint32_t byte_order;
+        uint32_t index_size;
+        uint32_t record_sizes[NUM_SECTIONS];
+        uint32_t padding;
+        uint64_t counts[NUM_SECTIONS];
+
+        // Byte offsets of the arrays from the start of the file, multiples of GRAPH_FILE_ALIGNMENT.
+        uint64_t offsets[NUM_SECTIONS];
+        uint64_t file_size;
+    };
+
+    static void initHeader(Graph_File_Header & header)
+    {
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, GRAPH_FILE_MAGIC, sizeof(GRAPH_FILE_MAGIC));
+        header.version    = GRAPH_FILE_VERSION;
+        header.byte_order = GRAPH_FILE_BYTE_ORDER;
+        header.index_size = sizeof(Index);
+        header.record_sizes[VERTICES]  = sizeof(Vertex);
+        header.record_sizes[EDGES]     = sizeof(Edge);
+        header.record_sizes[HALFEDGES] = sizeof(Halfedge);
+        header.record_sizes[FACES]     = sizeof(Face);
+    }
+
+    static uint64_t align(uint64_t offset)
+    {
+        return (offset + GRAPH_FILE_ALIGNMENT - 1) / GRAPH_FILE_ALIGNMENT * GRAPH_FILE_ALIGNMENT;
+    }
+
+    // -- Saving.
+
+    // Writes zeros up to the given offset.
+    static bool pad(FILE * file, uint64_t & written, uint64_t offset)
+    {
+        static const char zeros[GRAPH_FILE_ALIGNMENT] = {0};
+
+        size_t len = (size_t)(offset - written);
+        written = offset;
+        return fwrite(zeros, 1, len, file) == len;
+    }
+
+    static bool writeSection(FILE * file, uint64_t & written, uint64_t offset, const void * elements, size_t len)
+    {
+        if (!pad(file, written, offset))
+        {
+            return false;
+        }
+
+        written += len;
+        return len == 0 || fwrite(elements, 1, len, file) == len;
+    }
+
+    // Writes the elements with IDs 0 to count - 1 of one type, one chunk of contiguous elements at a time.
+    template <class Element>
+    static bool writeElements(FILE * file, uint64_t & written, uint64_t offset,
+                              const Graph * graph, size_t count, const Element * (Graph::*getElement)(Index) const)
+    {
+        if (!pad(file, written, offset))
+        {
+            return false;
+        }
+
+        for (size_t first = 0; first < count; first += GRAPH_CHUNK_SIZE)
+        {
+            size_t len = min(GRAPH_CHUNK_SIZE, count - first) * sizeof(Element);
+            if (fwrite((graph ->* getElement)((Index)first), 1, len, file) != len)
+            {
+                return false;
+            }
+
+            written += len;
+        }
+
+        return true;
+    }
+
+    bool saveGraph(const Graph * graph, const std::string & path)
+    {
+        // Files never hold tombstones, so every element of a loaded graph is live.
+        if (graph -> hasRemovedElements())
+        {
+            return false;
+        }
+
+        Graph_File_Header header;
+        initHeader(header);
+
+        header.counts[VERTICES]  = graph -> numVertices();
+        header.counts[EDGES]     = graph -> numEdges();
+        header.counts[HALFEDGES] = graph -> numHalfedges();
+        header.counts[FACES]     = graph -> numFaces();
+
+        uint64_t offset = sizeof(header);
+        for (int i = 0; i < NUM_SECTIONS; i++)
+        {
+            header.offsets[i] = align(offset);
+            offset = header.offsets[i] + header.counts[i] * header.record_sizes[i];
+        }
+        header.file_size = offset;
+
+        FILE * file = fopen(path.c_str(), "wb");
+        if (file == NULL)
+        {
+            return false;
+        }
+
+        uint64_t written = 0;
+        bool ok = writeSection(file, written, 0, &header, sizeof(header));
+        ok = ok && writeElements(file, written, header.offsets[VERTICES],  graph, graph -> numVertices(),  &Graph::getVertex);
+        ok = ok && writeElements(file, written, header.offsets[EDGES],     graph, graph -> numEdges(),     &Graph::getEdge);
+        ok = ok && writeElements(file, written, header.offsets[HALFEDGES], graph, graph -> numHalfedges(), &Graph::getHalfedge);
+        ok = ok && writeElements(file, written, header.offsets[FACES],     graph, graph -> numFaces(),     &Graph::getFace);
+
+        // fclose flushes the buffered tail, which may also fail.
+        ok = (fclose(file) == 0) && ok;
+
+        if (!ok)
+        {
+            remove(path.c_str());
+        }
+
+        return ok;
+    }
+
+    // -- Loading.
+
+    // A whole file mapped copy on write, unmapped when deleted.
+    class Mapped_File : public Graph_Storage
+    {
+    public:
+
+        Mapped_File()
+        {
+            bytes = NULL;
+            size  = 0;
+#ifdef _WIN32
+            mapping = NULL;
+#endif
+        }
+
+        virtual ~Mapped_File()
+        {
+#ifdef _WIN32
+            if (bytes != NULL)
+            {
+                UnmapViewOfFile(bytes);
+            }
+
+            if (mapping != NULL)
+            {
+                CloseHandle(mapping);
+            }
+#else
+            if (bytes != NULL)
+            {
+                munmap(bytes, size);
+            }
+#endif
+        }
+
+        // Returns false if the file could not be opened or mapped, or is empty.
+        bool open(const std::string & path)
+        {
+#ifdef _WIN32
+            HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+            if (file == INVALID_HANDLE_VALUE)
+            {
+                return false;
+            }
+
+            LARGE_INTEGER file_size;
+            if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0 || (uint64_t)file_size.QuadPart > SIZE_MAX)
+            {
+                CloseHandle(file);
+                return false;
+            }
+            size = (size_t)file_size.QuadPart;
+
+            // The mapping keeps the file open.
+            mapping = CreateFileMappingA(file, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+            CloseHandle(file);
+            if (mapping == NULL)
+            {
+                return false;
+            }
+
+            bytes = (char *)MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+            return bytes != NULL;
+#else
+            int file = ::open(path.c_str(), O_RDONLY);
+            if (file < 0)
+            {
+                return false;
+            }
+
+            struct stat status;
+            if (fstat(file, &status) != 0 || status.st_size <= 0 || (uint64_t)status.st_size > SIZE_MAX)
+            {
+                close(file);
+                return false;
+            }
+            size = (size_t)status.st_size;
+
+            // The mapping keeps the file open.
+            void * address = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, file, 0);
+            close(file);
+            if (address == MAP_FAILED)
+            {
+                return false;
+            }
+
+            bytes = (char *)address;
+            return true;
+#endif
+        }
+
+        char * bytes;
+        size_t size;
+
+    private:
+#ifdef _WIN32
+        HANDLE mapping;
+#endif
+    };
+
+    // Returns true iff the given header was written by a compatible build and its arrays lie within the file.
+    static bool validHeader(const Graph_File_Header & header, uint64_t file_size)
+    {
+        Graph_File_Header expected;
+        initHeader(expected);
+
+        if (memcmp(header.magic, expected.magic, sizeof(header.magic)) != 0 ||
+            header.version    != expected.version    ||
+            header.byte_order != expected.byte_order ||
+            header.index_size != expected.index_size ||
+            header.file_size  != file_size)
+        {
+            return false;
+        }
+
+        uint64_t end = sizeof(header);
+        for (int i = 0; i < NUM_SECTIONS; i++)
+        {
+            if (header.record_sizes[i] != expected.record_sizes[i] ||
+                header.offsets[i] % GRAPH_FILE_ALIGNMENT != 0 ||
+                header.offsets[i] < end || header.offsets[i] > file_size ||
+                header.counts[i] > (file_size - header.offsets[i]) / header.record_sizes[i] ||
+                !fitsIndex(header.counts[i]))
+            {
+                return false;
+            }
+
+            end = header.offsets[i] + header.counts[i] * header.record_sizes[i];
+        }
+
+        return true;
+    }
+
+    // Returns true iff the given ID is less than the given count or is NULL_ID and allowed to be.
+    static bool validLink(Index ID, uint64_t count, bool may_be_null)
+    {
+        return ID < count || (may_be_null && ID == NULL_ID);
+    }
+
+    // Records the targets of one type of halfedge link, to check that no two halfedges link to the same halfedge.
+    // One bit per halfedge, so the random accesses stay within a cache friendly bitmap rather than the mapped halfedges.
+    class Link_Targets
+    {
+    public:
+
+        Link_Targets(uint64_t count) : bits((size_t)((count + 63) / 64), 0)
+        {
+        }
+
+        // Returns false if the given halfedge was already a target.
+        bool add(Index ID)
+        {
+            uint64_t & word = bits[(size_t)(ID / 64)];
+            uint64_t bit = (uint64_t)1 << (ID % 64);
+            bool fresh = (word & bit) == 0;
+            word |= bit;
+            return fresh;
+        }
+
+    private:
+        std::vector<uint64_t> bits;
+    };
+
+    // Returns true iff every ID and link of the mapped elements refers to an element that exists
+    // and the twin, next and prev links are each a permutation of the halfedges,
+    // so traversals of a corrupt file can neither leave the arrays nor loop forever.
+    // The twin and prev links are not checked against the next links,
+    // which would cost a random access into the halfedges per link.
+    static bool validElements(const Graph * graph)
+    {
+        uint64_t num_vertices  = graph -> numVertices();
+        uint64_t num_edges     = graph -> numEdges();
+        uint64_t num_halfedges = graph -> numHalfedges();
+        uint64_t num_faces     = graph -> numFaces();
+
+        for (Index i = 0; i < num_vertices; i++)
+        {
+            const Vertex * vertex = graph -> getVertex(i);
+            if (vertex -> ID != i || !validLink(vertex -> halfedge, num_halfedges, true))
+            {
+                return false;
+            }
+        }
+
+        for (Index i = 0; i < num_edges; i++)
+        {
+            const Edge * edge = graph -> getEdge(i);
+            if (edge -> ID != i || !validLink(edge -> halfedge, num_halfedges, true))
+            {
+                return false;
+            }
+        }
+
+        Link_Targets twins(num_halfedges);
+        Link_Targets nexts(num_halfedges);
+        Link_Targets prevs(num_halfedges);
+
+        for (Index i = 0; i < num_halfedges; i++)
+        {
+            const Halfedge * halfedge = graph -> getHalfedge(i);
+            if (halfedge -> ID != i ||
+                !validLink(halfedge -> twin,   num_halfedges, false) ||
+                !validLink(halfedge -> next,   num_halfedges, false) ||
+                !validLink(halfedge -> prev,   num_halfedges, false) ||
+                !validLink(halfedge -> face,   num_faces,     true)  ||
+                !validLink(halfedge -> edge,   num_edges,     true)  ||
+                !validLink(halfedge -> vertex, num_vertices,  false) ||
+                !validLink(halfedge -> data.next_extraordinary, num_halfedges, true))
+            {
+                return false;
+            }
+
+            // Every halfedge is the target of at most one link of each type, so each type of link is a permutation.
+            if (!twins.add(halfedge -> twin) || !nexts.add(halfedge -> next) || !prevs.add(halfedge -> prev))
+            {
+                return false;
+            }
+        }
+
+        for (Index i = 0; i < num_faces; i++)
+        {
+            const Face * face = graph -> getFace(i);
+            if (face -> ID != i ||
+                !validLink(face -> halfedge, num_halfedges, true) ||
+                !validLink(face -> data.first_hole, num_faces, true) ||
+                !validLink(face -> data.next_hole,  num_faces, true))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    Graph * loadGraph(const std::string & path)
+    {
+        Mapped_File * file = new Mapped_File();
+        if (!file -> open(path) || file -> size < sizeof(Graph_File_Header))
+        {
+            delete file;
+            return NULL;
+        }
+
+        Graph_File_Header header;
+        memcpy(&header, file -> bytes, sizeof(header));
+        if (!validHeader(header, file -> size))
+        {
+            delete file;
+            return NULL;
+        }
+
+        Graph * graph = new Graph();
+        graph -> data = new Graph_Data(graph);
+        graph -> attach((Vertex   *)(file -> bytes + header.offsets[VERTICES]),  (size_t)header.counts[VERTICES],
+                        (Edge     *)(file -> bytes + header.offsets[EDGES]),     (size_t)header.counts[EDGES],
+                        (Halfedge *)(file -> bytes + header.offsets[HALFEDGES]), (size_t)header.counts[HALFEDGES],
+                        (Face     *)(file -> bytes + header.offsets[FACES]),     (size_t)header.counts[FACES],
+                        file);
+
+        // Deleting the graph also unmaps the file.
+        if (!validElements(graph))
+        {
+            delete graph;
+            return NULL;
+        }
+
+        return graph;
+    }
+
+}
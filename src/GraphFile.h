@@ -0,0 +1,47 @@
+#pragma once
+
+/*
+* Graph Files.
+*
+* Written on 10/17/2026.
+*
+* Purpose: Saves embedded graphs, so that archived scribbles may be loaded again without embedding them again.
+*
+* A graph file is a header followed by the vertex, edge, halfedge and face arrays,
+* each stored exactly as the elements are laid out in memory and aligned to GRAPH_FILE_ALIGNMENT bytes.
+* The elements hold no pointers, only the IDs of the elements they link to, so the file needs no translation.
+* Loading maps the file copy on write and attaches the graph to the mapped arrays, see Graph_T::attach,
+* so loading costs one validation pass over the links rather than a copy. Read only post processing runs on the mapped image,
+* and writes to the elements, e.g. building a Chain_View, only copy the pages they touch.
+*
+* The header records the format version, the byte order, the width of scrib::Index and the size of every element record.
+* A file is only loaded by builds that agree on all of them, so a change to the layout of an element or its data
+* must increase GRAPH_FILE_VERSION.
+*
+* The Graph_Data, i.e. the permutation, vertex stars and chain view, is not saved.
+*/
+
+#include <string>
+#include <stdint.h>
+#include "ofMain.h"
+#include "HalfedgeGraph.h"
+#include "PolylineGraphData.h"
+
+namespace scrib
+{
+
+    const uint32_t GRAPH_FILE_VERSION = 1;
+    const uint32_t GRAPH_FILE_ALIGNMENT = 64;
+
+    // Writes the given graph to the file at the given path in one sequential pass.
+    // Returns false if the file could not be written or the graph has removed elements, see Graph_T::removeFace,
+    // which GraphMutator::compact drops.
+    bool saveGraph(const Graph * graph, const std::string & path);
+
+    // Maps the graph file at the given path and returns a graph that uses the mapped elements in place.
+    // The mapping is released when the graph is deleted or reset.
+    // Returns NULL if the file could not be mapped, was written by an incompatible build
+    // or fails validation, e.g. a link to an element that does not exist.
+    Graph * loadGraph(const std::string & path);
+
+}
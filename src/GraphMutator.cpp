@@ -0,0 +1,887 @@
+/*
+*  GraphMutator.cpp
+*
+*  Written on 10/17/2026.
+*
+*/
+
+#include "GraphMutator.h"
+#include <algorithm>
+
+namespace scrib
+{
+
+    void GraphMutator::load_graph(Graph * graph)
+    {
+        this -> graph = graph;
+
+        compacting = false;
+        moves.clear();
+        free_vertex = free_edge = free_halfedge = free_face = 0;
+        hole_owners.clear();
+
+        if (graph == NULL)
+        {
+            return;
+        }
+
+        for (Face_Iter iter = graph -> facesBegin(); iter != graph -> facesEnd(); ++iter)
+        {
+            if ((*iter) -> data.first_hole != NULL_ID)
+            {
+                hole_owners.push_back((*iter) -> ID);
+            }
+        }
+    }
+
+    Index GraphMutator::splitEdge(Index edge, const ofPoint & point)
+    {
+        // Before: h goes from u to v and t from v to u.
+        // After:  h goes from u to w, n from w to v, t from v to w and m from w to u.
+        Index h = graph -> getEdge(edge) -> halfedge;
+        Index t = halfedge(h) -> twin;
+        Index h_next = halfedge(h) -> next;
+        Index t_next = halfedge(t) -> next;
+
+        Vertex * vertex = graph -> newVertex();
+        Index w = vertex -> ID;
+        vertex -> data.point = point;
+
+        Index n = graph -> newHalfedge() -> ID;
+        Index m = graph -> newHalfedge() -> ID;
+        Index split = graph -> newEdge() -> ID;
+
+        // The original edge keeps h and m, the new edge gets n and t.
+        graph -> getEdge(edge) -> halfedge = h;
+        graph -> getEdge(split) -> halfedge = n;
+
+        halfedge(h) -> twin = m;
+        halfedge(m) -> twin = h;
+        halfedge(n) -> twin = t;
+        halfedge(t) -> twin = n;
+
+        halfedge(m) -> edge = edge;
+        halfedge(n) -> edge = split;
+        halfedge(t) -> edge = split;
+
+        halfedge(n) -> vertex = w;
+        halfedge(m) -> vertex = w;
+        graph -> getVertex(w) -> halfedge = n;
+
+        halfedge(n) -> face = halfedge(h) -> face;
+        halfedge(m) -> face = halfedge(t) -> face;
+
+        link(h, n);
+        link(n, h_next);
+        link(t, m);
+        link(m, t_next);
+
+        invalidate_views();
+
+        Graph_Permutation & permutation = graph -> data -> permutation;
+        record_new(permutation.original_vertices, w);
+        record_new(permutation.original_edges, split);
+        record_new(permutation.original_halfedges, n);
+        record_new(permutation.original_halfedges, m);
+
+        end_edit();
+
+        return moved(moves.vertices, w);
+    }
+
+    Index GraphMutator::insertEdge(Index vertex1, Index vertex2, Index face)
+    {
+        if (vertex1 == vertex2)
+        {
+            return NULL_ID;
+        }
+
+        Index a = find_corner(vertex1, face);
+        Index b = find_corner(vertex2, face);
+        if (a == NULL_ID || b == NULL_ID)
+        {
+            return NULL_ID;
+        }
+
+        Index a_prev = halfedge(a) -> prev;
+        Index b_prev = halfedge(b) -> prev;
+
+        Index edge, h, t;
+        new_edge(edge, h, t);
+        halfedge(h) -> vertex = vertex1;
+        halfedge(t) -> vertex = vertex2;
+
+        // h closes the cycle from b to the corner before a, t closes the cycle from a to the corner before b.
+        link(a_prev, h);
+        link(h, b);
+        link(b_prev, t);
+        link(t, a);
+
+        // The smaller part becomes the new face.
+        Index smaller = smaller_cycle(h, t);
+        Index larger  = smaller == h ? t : h;
+
+        Face * split = graph -> newFace();
+        Index split_ID = split -> ID;
+        split -> halfedge = smaller;
+        set_face(smaller, split_ID);
+        halfedge(larger) -> face = face;
+
+        graph -> getFace(face) -> halfedge = larger;
+
+        classify(vertex1);
+        classify(vertex2);
+
+        invalidate_views();
+
+        Graph_Permutation & permutation = graph -> data -> permutation;
+        record_new(permutation.original_edges, edge);
+        record_new(permutation.original_halfedges, h);
+        record_new(permutation.original_halfedges, t);
+        record_new(permutation.original_faces, split_ID);
+
+        end_edit();
+
+        return moved(moves.edges, edge);
+    }
+
+    bool GraphMutator::removeEdge(Index edge)
+    {
+        Index h = graph -> getEdge(edge) -> halfedge;
+        Index t = halfedge(h) -> twin;
+
+        if (halfedge(h) -> face == halfedge(t) -> face)
+        {
+            return false;
+        }
+
+        Index h_prev = halfedge(h) -> prev;
+        Index h_next = halfedge(h) -> next;
+        Index t_prev = halfedge(t) -> prev;
+        Index t_next = halfedge(t) -> next;
+        Index u = halfedge(h) -> vertex;
+        Index v = halfedge(t) -> vertex;
+
+        // The face of the smaller cycle is merged into the face of the larger cycle.
+        Index smaller   = smaller_cycle(h, t);
+        Index larger    = smaller == h ? t : h;
+        Index survivor  = halfedge(larger)  -> face;
+        Index merged    = halfedge(smaller) -> face;
+        set_face(smaller, survivor);
+
+        link(h_prev, t_next);
+        link(t_prev, h_next);
+
+        if (graph -> getVertex(u) -> halfedge == h)
+        {
+            graph -> getVertex(u) -> halfedge = t_next;
+        }
+
+        if (graph -> getVertex(v) -> halfedge == t)
+        {
+            graph -> getVertex(v) -> halfedge = h_next;
+        }
+
+        Face * face = graph -> getFace(survivor);
+        if (face -> halfedge == h || face -> halfedge == t)
+        {
+            face -> halfedge = h_next;
+        }
+
+        // Move the holes of the merged face to the end of the survivor's hole list.
+        Index holes = graph -> getFace(merged) -> data.first_hole;
+        if (holes != NULL_ID)
+        {
+            Face_Data & data = graph -> getFace(survivor) -> data;
+            if (data.first_hole == NULL_ID)
+            {
+                data.first_hole = holes;
+            }
+            else
+            {
+                Index last = data.first_hole;
+                while (graph -> getFace(last) -> data.next_hole != NULL_ID)
+                {
+                    last = graph -> getFace(last) -> data.next_hole;
+                }
+
+                graph -> getFace(last) -> data.next_hole = holes;
+            }
+
+            if (std::find(hole_owners.begin(), hole_owners.end(), survivor) == hole_owners.end())
+            {
+                hole_owners.push_back(survivor);
+            }
+        }
+
+        remove_face(merged);
+        remove_edge(edge, h, t);
+
+        classify(u);
+        classify(v);
+
+        invalidate_views();
+
+        end_edit();
+
+        return true;
+    }
+
+    Index GraphMutator::addTail(Index vertex, Index face, const ofPoint & point)
+    {
+        Index a = find_corner(vertex, face);
+        if (a == NULL_ID)
+        {
+            return NULL_ID;
+        }
+
+        Index a_prev = halfedge(a) -> prev;
+
+        Vertex * tail = graph -> newVertex();
+        Index w = tail -> ID;
+        tail -> data.point = point;
+
+        Index edge, h, t;
+        new_edge(edge, h, t);
+        halfedge(h) -> vertex = vertex;
+        halfedge(t) -> vertex = w;
+        halfedge(h) -> face = face;
+        halfedge(t) -> face = face;
+        graph -> getVertex(w) -> halfedge = t;
+
+        // The face goes out along the tail and back before it continues along a.
+        link(a_prev, h);
+        link(h, t);
+        link(t, a);
+
+        classify(vertex);
+        classify(w);
+
+        invalidate_views();
+
+        Graph_Permutation & permutation = graph -> data -> permutation;
+        record_new(permutation.original_vertices, w);
+        record_new(permutation.original_edges, edge);
+        record_new(permutation.original_halfedges, h);
+        record_new(permutation.original_halfedges, t);
+
+        end_edit();
+
+        return moved(moves.vertices, w);
+    }
+
+    bool GraphMutator::removeTail(Index vertex)
+    {
+        // A tail has one outgoing halfedge, which follows its twin.
+        Index out = graph -> getVertex(vertex) -> halfedge;
+        if (out == NULL_ID)
+        {
+            return false;
+        }
+
+        Index in = halfedge(out) -> twin;
+        if (halfedge(in) -> next != out)
+        {
+            return false;
+        }
+
+        Index next = halfedge(out) -> next;
+        Index prev = halfedge(in) -> prev;
+
+        // The other end is also a tail, so the edge is its own component.
+        if (next == in)
+        {
+            return false;
+        }
+
+        Index u = halfedge(in) -> vertex;
+        link(prev, next);
+
+        if (graph -> getVertex(u) -> halfedge == in)
+        {
+            graph -> getVertex(u) -> halfedge = next;
+        }
+
+        Face * face = graph -> getFace(halfedge(out) -> face);
+        if (face -> halfedge == in || face -> halfedge == out)
+        {
+            face -> halfedge = next;
+        }
+
+        remove_vertex(vertex);
+        remove_edge(halfedge(out) -> edge, out, in);
+
+        classify(u);
+
+        invalidate_views();
+
+        end_edit();
+
+        return true;
+    }
+
+    Index GraphMutator::find_corner(Index vertex, Index face)
+    {
+        Index start = graph -> getVertex(vertex) -> halfedge;
+        if (start == NULL_ID)
+        {
+            return NULL_ID;
+        }
+
+        Index current = start;
+        do
+        {
+            if (halfedge(current) -> face == face)
+            {
+                return current;
+            }
+
+            current = halfedge(halfedge(current) -> twin) -> next;
+        } while (current != start);
+
+        return NULL_ID;
+    }
+
+    void GraphMutator::new_edge(Index & edge, Index & h, Index & t)
+    {
+        edge = graph -> newEdge() -> ID;
+        h    = graph -> newHalfedge() -> ID;
+        t    = graph -> newHalfedge() -> ID;
+
+        graph -> getEdge(edge) -> halfedge = h;
+        halfedge(h) -> edge = edge;
+        halfedge(t) -> edge = edge;
+        halfedge(h) -> twin = t;
+        halfedge(t) -> twin = h;
+    }
+
+    void GraphMutator::link(Index prev, Index next)
+    {
+        halfedge(prev) -> next = next;
+        halfedge(next) -> prev = prev;
+    }
+
+    Index GraphMutator::smaller_cycle(Index a, Index b)
+    {
+        Index current_a = halfedge(a) -> next;
+        Index current_b = halfedge(b) -> next;
+
+        while (current_a != a && current_b != b)
+        {
+            current_a = halfedge(current_a) -> next;
+            current_b = halfedge(current_b) -> next;
+        }
+
+        return current_a == a ? a : b;
+    }
+
+    void GraphMutator::set_face(Index start, Index face)
+    {
+        Index current = start;
+        do
+        {
+            Halfedge * halfedge = graph -> getHalfedge(current);
+            halfedge -> face = face;
+            current = halfedge -> next;
+        } while (current != start);
+    }
+
+    void GraphMutator::classify(Index vertex)
+    {
+        Vertex * v = graph -> getVertex(vertex);
+
+        Index degree = 0;
+        Index start  = v -> halfedge;
+        if (start != NULL_ID)
+        {
+            Index current = start;
+            do
+            {
+                degree++;
+                current = halfedge(halfedge(current) -> twin) -> next;
+            } while (current != start);
+        }
+
+        Vertex_Data & data = v -> data;
+        data.singleton_point    = degree == 0;
+        data.tail_point         = degree == 1;
+        data.intersection_point = degree > 2;
+    }
+
+    void GraphMutator::remove_vertex(Index vertex)
+    {
+        Graph_Permutation & permutation = graph -> data -> permutation;
+
+        graph -> removeVertex(vertex);
+        record_removed(permutation.original_vertices, permutation.current_vertices, vertex);
+        free_vertex = std::min(free_vertex, vertex);
+    }
+
+    void GraphMutator::remove_face(Index face)
+    {
+        Graph_Permutation & permutation = graph -> data -> permutation;
+
+        graph -> removeFace(face);
+        record_removed(permutation.original_faces, permutation.current_faces, face);
+        free_face = std::min(free_face, face);
+
+        std::vector<Index>::iterator owner = std::find(hole_owners.begin(), hole_owners.end(), face);
+        if (owner != hole_owners.end())
+        {
+            hole_owners.erase(owner);
+        }
+    }
+
+    void GraphMutator::remove_edge(Index edge, Index h, Index t)
+    {
+        Graph_Permutation & permutation = graph -> data -> permutation;
+
+        graph -> removeEdge(edge);
+        graph -> removeHalfedge(h);
+        graph -> removeHalfedge(t);
+
+        record_removed(permutation.original_edges, permutation.current_edges, edge);
+        record_removed(permutation.original_halfedges, permutation.current_halfedges, h);
+        record_removed(permutation.original_halfedges, permutation.current_halfedges, t);
+
+        free_edge = std::min(free_edge, edge);
+        free_halfedge = std::min(free_halfedge, std::min(h, t));
+    }
+
+    void GraphMutator::invalidate_views()
+    {
+        Chain_View & chains = graph -> data -> chains;
+        if (!chains.empty())
+        {
+            // Compaction may drop the halfedges that the links point to.
+            for (Halfedge_Iter iter = graph -> halfedgesBegin(); iter != graph -> halfedgesEnd(); ++iter)
+            {
+                (*iter) -> data.next_extraordinary = NULL_ID;
+            }
+
+            chains.clear();
+        }
+
+        graph -> data -> stars.clear();
+    }
+
+    void GraphMutator::record_new(std::vector<Index> & original, Index ID)
+    {
+        if (!original.empty() && original.size() <= ID)
+        {
+            original.resize(ID + 1, NULL_ID);
+        }
+    }
+
+    void GraphMutator::record_removed(std::vector<Index> & original, std::vector<Index> & current, Index ID)
+    {
+        if (original.empty())
+        {
+            return;
+        }
+
+        Index original_ID = original[ID];
+        if (original_ID != NULL_ID)
+        {
+            current[original_ID] = NULL_ID;
+        }
+
+        original[ID] = NULL_ID;
+    }
+
+    void GraphMutator::record_moved(std::vector<Index> & original, std::vector<Index> & current, Index from, Index to)
+    {
+        if (original.empty())
+        {
+            return;
+        }
+
+        Index original_ID = original[from];
+        if (original_ID != NULL_ID)
+        {
+            current[original_ID] = to;
+        }
+
+        original[to]   = original_ID;
+        original[from] = NULL_ID;
+    }
+
+    // -- Compaction.
+
+    double GraphMutator::fragmentation()
+    {
+        size_t removed = graph -> numRemovedVertices() + graph -> numRemovedEdges() +
+                         graph -> numRemovedHalfedges() + graph -> numRemovedFaces();
+        size_t total   = graph -> numVertices() + graph -> numEdges() + graph -> numHalfedges() + graph -> numFaces();
+
+        return total == 0 ? 0 : (double)removed / total;
+    }
+
+    void GraphMutator::end_edit()
+    {
+        moves.clear();
+
+        if (!compacting && compaction_threshold < 1 && fragmentation() > compaction_threshold)
+        {
+            compacting = true;
+        }
+
+        if (compacting)
+        {
+            compacting = !compactIncrementally(compaction_budget);
+        }
+    }
+
+    bool GraphMutator::compactIncrementally(size_t budget)
+    {
+        moves.clear();
+
+        if (!graph -> hasRemovedElements())
+        {
+            return true;
+        }
+
+        invalidate_views();
+        trim_removed();
+
+        // One element of every type at a time, so that every type makes progress.
+        size_t work = 0;
+        while (work < budget && graph -> hasRemovedElements())
+        {
+            if (graph -> numRemovedHalfedges() > 0)
+            {
+                work += move_halfedge(free_halfedge);
+            }
+
+            if (graph -> numRemovedEdges() > 0)
+            {
+                work += move_edge(free_edge);
+            }
+
+            if (graph -> numRemovedVertices() > 0)
+            {
+                work += move_vertex(free_vertex);
+            }
+
+            if (graph -> numRemovedFaces() > 0)
+            {
+                work += move_face(free_face);
+            }
+        }
+
+        return !graph -> hasRemovedElements();
+    }
+
+    // Numbers the live elements densely in their current order and the tombstones after them, so new_IDs is a permutation.
+    // The map gets the same IDs, but NULL_ID for the tombstones. Returns the number of live elements.
+    template <class Iter>
+    static Index dense_IDs(Iter begin, Iter end, size_t count, std::vector<Index> & new_IDs, std::vector<Index> & map)
+    {
+        new_IDs.assign(count, NULL_ID);
+
+        Index live = 0;
+        for (Iter iter = begin; iter != end; ++iter)
+        {
+            new_IDs[(*iter) -> ID] = live++;
+        }
+
+        map = new_IDs;
+
+        Index next = live;
+        for (Index i = 0; i < count; i++)
+        {
+            if (new_IDs[i] == NULL_ID)
+            {
+                new_IDs[i] = next++;
+            }
+        }
+
+        return live;
+    }
+
+    // Composes the permutation of a relabeled graph with the map of a compaction.
+    static void compose(const std::vector<Index> & map, Index live, std::vector<Index> & original, std::vector<Index> & current)
+    {
+        if (original.empty())
+        {
+            return;
+        }
+
+        std::vector<Index> new_original(live, NULL_ID);
+        for (Index i = 0; i < map.size(); i++)
+        {
+            if (map[i] != NULL_ID)
+            {
+                new_original[map[i]] = original[i];
+            }
+        }
+
+        original.swap(new_original);
+
+        std::fill(current.begin(), current.end(), NULL_ID);
+        for (Index i = 0; i < live; i++)
+        {
+            if (original[i] != NULL_ID)
+            {
+                current[original[i]] = i;
+            }
+        }
+    }
+
+    Graph_ID_Map GraphMutator::compact()
+    {
+        moves.clear();
+        compacting = false;
+
+        Graph_ID_Map map;
+        std::vector<Index> vertex_IDs, edge_IDs, halfedge_IDs, face_IDs;
+
+        Index num_vertices  = dense_IDs(graph -> verticesBegin(),  graph -> verticesEnd(),  graph -> numVertices(),  vertex_IDs,   map.vertices);
+        Index num_edges     = dense_IDs(graph -> edgesBegin(),     graph -> edgesEnd(),     graph -> numEdges(),     edge_IDs,     map.edges);
+        Index num_halfedges = dense_IDs(graph -> halfedgesBegin(), graph -> halfedgesEnd(), graph -> numHalfedges(), halfedge_IDs, map.halfedges);
+        Index num_faces     = dense_IDs(graph -> facesBegin(),     graph -> facesEnd(),     graph -> numFaces(),     face_IDs,     map.faces);
+
+        // Every ID stays the same.
+        if (!graph -> hasRemovedElements())
+        {
+            return map;
+        }
+
+        invalidate_views();
+
+        // Rewrites every link in one pass over every array, which leaves the tombstones at the ends.
+        graph -> permute(vertex_IDs, edge_IDs, halfedge_IDs, face_IDs);
+        graph -> trimRemoved();
+
+        // -- The IDs stored in the associated data.
+        for (Face_Iter iter = graph -> facesBegin(); iter != graph -> facesEnd(); ++iter)
+        {
+            Face_Data & data = (*iter) -> data;
+            data.first_hole = Graph::remap(map.faces, data.first_hole);
+            data.next_hole  = Graph::remap(map.faces, data.next_hole);
+        }
+
+        for (size_t i = 0; i < hole_owners.size(); i++)
+        {
+            hole_owners[i] = map.faces[hole_owners[i]];
+        }
+
+        Graph_Permutation & permutation = graph -> data -> permutation;
+        compose(map.vertices,  num_vertices,  permutation.original_vertices,  permutation.current_vertices);
+        compose(map.edges,     num_edges,     permutation.original_edges,     permutation.current_edges);
+        compose(map.halfedges, num_halfedges, permutation.original_halfedges, permutation.current_halfedges);
+        compose(map.faces,     num_faces,     permutation.original_faces,     permutation.current_faces);
+
+        free_vertex   = num_vertices;
+        free_edge     = num_edges;
+        free_halfedge = num_halfedges;
+        free_face     = num_faces;
+
+        return map;
+    }
+
+    static void fit(std::vector<Index> & original, size_t size)
+    {
+        if (!original.empty())
+        {
+            original.resize(size);
+        }
+    }
+
+    void GraphMutator::trim_removed()
+    {
+        graph -> trimRemoved();
+
+        Graph_Permutation & permutation = graph -> data -> permutation;
+        fit(permutation.original_vertices,  graph -> numVertices());
+        fit(permutation.original_edges,     graph -> numEdges());
+        fit(permutation.original_halfedges, graph -> numHalfedges());
+        fit(permutation.original_faces,     graph -> numFaces());
+    }
+
+    Index GraphMutator::moved(const std::vector<ID_Move> & moves, Index ID)
+    {
+        for (size_t i = 0; i < moves.size(); i++)
+        {
+            if (moves[i].from == ID)
+            {
+                ID = moves[i].to;
+            }
+        }
+
+        return ID;
+    }
+
+    // Every move takes the last element of its type, which is live since the arrays are trimmed after every move,
+    // and the first tombstone at or after free, since every element before free is live.
+
+    size_t GraphMutator::move_vertex(Index & free)
+    {
+        Index to = free;
+        while (graph -> getVertex(to) -> ID != NULL_ID)
+        {
+            to++;
+        }
+
+        Index from = graph -> numVertices() - 1;
+        graph -> moveVertex(from, to);
+        size_t work = to - free + 1;
+        free = to + 1;
+
+        // The halfedges leaving the vertex.
+        Index start = graph -> getVertex(to) -> halfedge;
+        if (start != NULL_ID)
+        {
+            Index current = start;
+            do
+            {
+                halfedge(current) -> vertex = to;
+                current = halfedge(halfedge(current) -> twin) -> next;
+                work++;
+            } while (current != start);
+        }
+
+        Graph_Permutation & permutation = graph -> data -> permutation;
+        record_moved(permutation.original_vertices, permutation.current_vertices, from, to);
+        moves.vertices.push_back(ID_Move(from, to));
+        trim_removed();
+
+        return work;
+    }
+
+    size_t GraphMutator::move_edge(Index & free)
+    {
+        Index to = free;
+        while (graph -> getEdge(to) -> ID != NULL_ID)
+        {
+            to++;
+        }
+
+        Index from = graph -> numEdges() - 1;
+        graph -> moveEdge(from, to);
+        size_t work = to - free + 2;
+        free = to + 1;
+
+        Index h = graph -> getEdge(to) -> halfedge;
+        halfedge(h) -> edge = to;
+        halfedge(halfedge(h) -> twin) -> edge = to;
+
+        Graph_Permutation & permutation = graph -> data -> permutation;
+        record_moved(permutation.original_edges, permutation.current_edges, from, to);
+        moves.edges.push_back(ID_Move(from, to));
+        trim_removed();
+
+        return work;
+    }
+
+    size_t GraphMutator::move_halfedge(Index & free)
+    {
+        Index to = free;
+        while (halfedge(to) -> ID != NULL_ID)
+        {
+            to++;
+        }
+
+        Index from = graph -> numHalfedges() - 1;
+        graph -> moveHalfedge(from, to);
+        size_t work = to - free + 6;
+        free = to + 1;
+
+        // The links of the halfedge to itself, e.g. in the loops of a singleton graph, then the links to it.
+        Halfedge * element = halfedge(to);
+        element -> twin = element -> twin == from ? to : element -> twin;
+        element -> next = element -> next == from ? to : element -> next;
+        element -> prev = element -> prev == from ? to : element -> prev;
+
+        halfedge(element -> twin) -> twin = to;
+        halfedge(element -> next) -> prev = to;
+        halfedge(element -> prev) -> next = to;
+
+        Vertex * vertex = graph -> getVertex(element -> vertex);
+        if (vertex -> halfedge == from)
+        {
+            vertex -> halfedge = to;
+        }
+
+        Edge * edge = graph -> getEdge(element -> edge);
+        if (edge -> halfedge == from)
+        {
+            edge -> halfedge = to;
+        }
+
+        Face * face = graph -> getFace(element -> face);
+        if (face -> halfedge == from)
+        {
+            face -> halfedge = to;
+        }
+
+        Graph_Permutation & permutation = graph -> data -> permutation;
+        record_moved(permutation.original_halfedges, permutation.current_halfedges, from, to);
+        moves.halfedges.push_back(ID_Move(from, to));
+        trim_removed();
+
+        return work;
+    }
+
+    size_t GraphMutator::move_face(Index & free)
+    {
+        Index to = free;
+        while (graph -> getFace(to) -> ID != NULL_ID)
+        {
+            to++;
+        }
+
+        Index from = graph -> numFaces() - 1;
+        graph -> moveFace(from, to);
+        size_t work = to - free + 1;
+        free = to + 1;
+
+        // The halfedges around the face.
+        Index start = graph -> getFace(to) -> halfedge;
+        if (start != NULL_ID)
+        {
+            Index current = start;
+            do
+            {
+                Halfedge * halfedge = graph -> getHalfedge(current);
+                halfedge -> face = to;
+                current = halfedge -> next;
+                work++;
+            } while (current != start);
+        }
+
+        // The hole lists that may hold the face.
+        for (size_t i = 0; i < hole_owners.size(); i++)
+        {
+            if (hole_owners[i] == from)
+            {
+                hole_owners[i] = to;
+            }
+
+            Face_Data & data = graph -> getFace(hole_owners[i]) -> data;
+            if (data.first_hole == from)
+            {
+                data.first_hole = to;
+            }
+
+            for (Index hole = data.first_hole; hole != NULL_ID; hole = graph -> getFace(hole) -> data.next_hole)
+            {
+                Face_Data & hole_data = graph -> getFace(hole) -> data;
+                if (hole_data.next_hole == from)
+                {
+                    hole_data.next_hole = to;
+                }
+
+                work++;
+            }
+        }
+
+        Graph_Permutation & permutation = graph -> data -> permutation;
+        record_moved(permutation.original_faces, permutation.current_faces, from, to);
+        moves.faces.push_back(ID_Move(from, to));
+        trim_removed();
+
+        return work;
+    }
+
+}
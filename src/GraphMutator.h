@@ -0,0 +1,250 @@
+#pragma once
+
+/*
+* Local Editing of Embedded Polyline Graphs.
+*
+* Written on 10/17/2026.
+*
+* Purpose: Edits the Graphs built by the PolylineGraphEmbedder in place, so that a small change to a drawing
+*          does not require embedding the whole drawing again.
+*
+* Every operator is a local Euler operator, which updates the twin, next, prev, face and vertex links,
+* the representative halfedges of the vertices, edges and faces, the face hole lists and the vertex classifications
+* in time proportional to the stars of the vertices involved and the smaller of the faces involved.
+*
+* Removed elements are left as tombstones, see Graph_T::removeFace, so the IDs of every other element stay valid.
+*
+* The mutator does not check geometry. The caller makes sure that new points and edges keep the embedding planar,
+* e.g. that an inserted edge lies within its face and crosses no other edge.
+*
+* Every edit clears the Chain_View and the vertex stars of the Graph_Data, which would be out of date.
+* The first edit after a Chain_View was built also resets every next_extraordinary link to NULL_ID,
+* which costs one pass over the halfedges, as building the view did.
+* The Graph_Permutation of a relabeled graph is kept up to date: new elements have no original ID
+* and removed elements no longer have a current ID.
+*
+* Compaction: Once the tombstones make up more than the compaction threshold of the elements, every edit also
+* moves a bounded number of the last live elements into the first tombstones, until none are left.
+* Moving an element only rewrites the links to it, so each edit does a bounded amount of extra work
+* and an interactive session never stalls for a full compaction. The moved elements are reported through getMoves,
+* and the IDs returned by the operators are already the IDs after the moves.
+* compact() renumbers the whole graph densely in one pass instead, e.g. before it is saved, see saveGraph.
+*/
+
+#include <vector>
+#include "ofMain.h"
+#include "HalfedgeGraph.h"
+#include "PolylineGraphData.h"
+
+namespace scrib
+{
+
+    // The old and new ID of an element moved by compaction.
+    struct ID_Move
+    {
+        Index from;
+        Index to;
+
+        ID_Move(Index from, Index to)
+        {
+            this -> from = from;
+            this -> to   = to;
+        }
+    };
+
+    // The elements moved by incremental compaction, in the order they were moved.
+    struct Graph_Moves
+    {
+        std::vector<ID_Move> vertices;
+        std::vector<ID_Move> edges;
+        std::vector<ID_Move> halfedges;
+        std::vector<ID_Move> faces;
+
+        bool empty() const
+        {
+            return vertices.empty() && edges.empty() && halfedges.empty() && faces.empty();
+        }
+
+        void clear()
+        {
+            vertices.clear();
+            edges.clear();
+            halfedges.clear();
+            faces.clear();
+        }
+    };
+
+    // Relates the IDs of the elements before a full compaction to their IDs after it.
+    struct Graph_ID_Map
+    {
+        // X[old ID] = new ID, or NULL_ID for removed elements.
+        std::vector<Index> vertices;
+        std::vector<Index> edges;
+        std::vector<Index> halfedges;
+        std::vector<Index> faces;
+    };
+
+    class GraphMutator
+    {
+    public:
+
+        GraphMutator(Graph * graph = NULL)
+        {
+            compaction_threshold = .25;
+            compaction_budget    = 256;
+            compacting = false;
+            load_graph(graph);
+        }
+
+        // Scans the faces of the given graph for hole lists once, so that compaction can rewrite the links to hole faces.
+        void load_graph(Graph * graph);
+
+        Graph * getGraph()
+        {
+            return this -> graph;
+        }
+
+        // -- Euler operators.
+
+        // Splits the given edge at a new vertex with the given point, which should lie on the edge.
+        // If the edge's halfedge went from u to v, the edge keeps the u side: its halfedge now goes from u to the new vertex
+        // and its twin from the new vertex to u. A new edge holds the v side, whose halfedge goes from the new vertex to v.
+        // Returns the ID of the new vertex.
+        Index splitEdge(Index edge, const ofPoint & point);
+
+        // Adds an edge from vertex1 to vertex2 through the given face, which both vertices must be on,
+        // splitting the face in two. The larger part keeps the face's ID and its holes.
+        // A vertex that touches the face more than once is linked at its first corner on the face.
+        // The edge's halfedge goes from vertex1 to vertex2.
+        // Returns the ID of the new edge, or NULL_ID if either vertex is not on the face or they are the same vertex.
+        Index insertEdge(Index vertex1, Index vertex2, Index face);
+
+        // Removes the given edge and merges the faces on either side of it.
+        // The larger face keeps its ID and gains the holes of the other face.
+        // Returns false if both sides of the edge are the same face, e.g. for tail edges, which would disconnect the graph.
+        bool removeEdge(Index edge);
+
+        // Adds a new tail vertex with the given point, linked to the given vertex by a new edge within the given face.
+        // Returns the ID of the new vertex, or NULL_ID if the vertex is not on the face.
+        Index addTail(Index vertex, Index face, const ofPoint & point);
+
+        // Removes the given tail vertex and its edge.
+        // Returns false if the vertex is not a tail or its edge is the only edge of its component.
+        bool removeTail(Index vertex);
+
+        // -- Compaction.
+
+        // Edits start compacting the graph once more than the given fraction of its elements are tombstones.
+        // A threshold of 1 or more turns automatic compaction off.
+        void setCompactionThreshold(double threshold)
+        {
+            compaction_threshold = threshold;
+        }
+
+        // Sets the work each edit may spend on compaction, roughly the number of links rewritten.
+        void setCompactionBudget(size_t budget)
+        {
+            compaction_budget = budget;
+        }
+
+        // Returns the fraction of the elements of the graph that are tombstones.
+        double fragmentation();
+
+        // Returns the elements moved by the last edit or compactIncrementally call.
+        const Graph_Moves & getMoves()
+        {
+            return moves;
+        }
+
+        // Moves live elements into tombstones until about the given amount of work is done, see setCompactionBudget.
+        // Returns true iff the graph has no tombstones left.
+        bool compactIncrementally(size_t budget);
+
+        // Renumbers the live elements densely in their current order, rewriting every link in one pass over the elements,
+        // and drops every tombstone. Returns the map from the old IDs to the new IDs.
+        Graph_ID_Map compact();
+
+    private:
+
+        Graph * graph;
+
+        double compaction_threshold;
+        size_t compaction_budget;
+
+        // True from the edit that crossed the compaction threshold until the graph has no tombstones left.
+        bool compacting;
+
+        Graph_Moves moves;
+
+        // The lowest IDs that may be tombstones, so finding the next tombstone to fill takes amortized constant time.
+        Index free_vertex;
+        Index free_edge;
+        Index free_halfedge;
+        Index free_face;
+
+        // The faces with hole lists. Hole faces are only linked to by these lists, so a moved face finds its links here.
+        std::vector<Index> hole_owners;
+
+        Halfedge * halfedge(Index ID)
+        {
+            return graph -> getHalfedge(ID);
+        }
+
+        // Returns the first halfedge around the given vertex that leaves it along the given face, or NULL_ID.
+        Index find_corner(Index vertex, Index face);
+
+        // Allocates an edge and its two halfedges, which are twins.
+        void new_edge(Index & edge, Index & halfedge, Index & twin);
+
+        // Links the given halfedges, so that next follows prev.
+        void link(Index prev, Index next);
+
+        // Returns whichever of the given halfedges is on the shorter next cycle, walking both cycles together,
+        // so it takes time proportional to the shorter cycle. Returns a if both are on the same cycle or the cycles are as long.
+        Index smaller_cycle(Index a, Index b);
+
+        // Sets the face of every halfedge in the cycle of the given halfedge.
+        void set_face(Index start, Index face);
+
+        // Recomputes the tail, intersection and singleton classification of the given vertex from its degree.
+        void classify(Index vertex);
+
+        // Removes the given element and records it as removed.
+        void remove_vertex(Index vertex);
+        void remove_face(Index face);
+        void remove_edge(Index edge, Index halfedge, Index twin);
+
+        // -- Keeping the Graph_Data up to date.
+
+        void invalidate_views();
+
+        // Records an element created with the given ID in the permutation of a relabeled graph.
+        void record_new(std::vector<Index> & original, Index ID);
+
+        // Records that the element with the given ID was removed in the permutation of a relabeled graph.
+        void record_removed(std::vector<Index> & original, std::vector<Index> & current, Index ID);
+
+        // Records that the element with ID from moved to ID to in the permutation of a relabeled graph.
+        void record_moved(std::vector<Index> & original, std::vector<Index> & current, Index from, Index to);
+
+        // -- Compaction.
+
+        // Takes a compaction step once the graph is fragmented enough, see setCompactionThreshold.
+        // Every edit ends with this, which also clears the moves of the previous edit.
+        void end_edit();
+
+        // Drops the tombstones at the ends of the arrays, along with their entries in the permutation.
+        void trim_removed();
+
+        // Returns the ID that the element with the given ID was moved to, following the given moves in order.
+        static Index moved(const std::vector<ID_Move> & moves, Index ID);
+
+        // Move the last live element of their type into the first tombstone, rewriting every link to it.
+        // Return the number of links rewritten.
+        size_t move_vertex(Index & free);
+        size_t move_edge(Index & free);
+        size_t move_halfedge(Index & free);
+        size_t move_face(Index & free);
+    };
+
+}
@@ -0,0 +1,157 @@
+#pragma once
+
+/*
+* Copy on Write Graph Snapshots.
+*
+* Written on 10/17/2026.
+*
+* Purpose: Lets readers, e.g. a thread rendering the current graph, keep a consistent version of a graph
+*          while a writer keeps editing it, without copying the graph.
+*
+* A snapshot shares the element chunks of the graph, see Element_Array, so taking one takes constant time.
+* The graph copies a chunk the first time it writes to it afterwards, so a snapshot never changes
+* and every version only owns the chunks that were touched since the previous version.
+* The chunks are freed once neither the graph nor any snapshot uses them.
+*
+* Typical use:
+*   Writer thread: edit the graph, then publisher.publish(graph).
+*   Reader threads: Graph_Snapshot::Handle handle = publisher.current(), then read handle -> getHalfedge(ID) etc.
+*
+* Snapshots only hold the elements, not the Graph_Data.
+* NOTE: Only the graph's non const getters copy shared chunks, so they and publish belong to the writer's thread.
+*       Queries through a const Graph, e.g. PolylineGraphPostProcessor, never copy and may run concurrently with each other,
+*       but not with the writer.
+*/
+
+#include <memory>
+#include <mutex>
+#include <stdint.h>
+#include "HalfedgeGraph.h"
+
+namespace scrib
+{
+
+    // An immutable version of the elements of a Graph_T.
+    template <class Payload>
+    class Graph_Snapshot_T
+    {
+    public:
+
+        typedef Graph_T<Payload> Graph;
+        typedef typename Graph::Face     Face;
+        typedef typename Graph::Vertex   Vertex;
+        typedef typename Graph::Edge     Edge;
+        typedef typename Graph::Halfedge Halfedge;
+
+        // Readers share snapshots through handles, which keep them alive.
+        typedef std::shared_ptr<const Graph_Snapshot_T> Handle;
+
+        // Takes a snapshot of the given graph in constant time, numbered with the given version.
+        Graph_Snapshot_T(Graph * graph, uint64_t version)
+        {
+            this -> version = version;
+            graph -> vertices.share(vertices);
+            graph -> edges.share(edges);
+            graph -> halfedges.share(halfedges);
+            graph -> faces.share(faces);
+        }
+
+        uint64_t getVersion() const
+        {
+            return version;
+        }
+
+        const Face * getFace(Index ID) const
+        {
+            return &faces.read(ID);
+        }
+
+        const Vertex * getVertex(Index ID) const
+        {
+            return &vertices.read(ID);
+        }
+
+        const Edge * getEdge(Index ID) const
+        {
+            return &edges.read(ID);
+        }
+
+        const Halfedge * getHalfedge(Index ID) const
+        {
+            return &halfedges.read(ID);
+        }
+
+        size_t numFaces() const
+        {
+            return faces.size();
+        }
+
+        size_t numVertices() const
+        {
+            return vertices.size();
+        }
+
+        size_t numEdges() const
+        {
+            return edges.size();
+        }
+
+        size_t numHalfedges() const
+        {
+            return halfedges.size();
+        }
+
+    private:
+
+        uint64_t version;
+
+        Element_Array<Face>     faces;
+        Element_Array<Vertex>   vertices;
+        Element_Array<Edge>     edges;
+        Element_Array<Halfedge> halfedges;
+    };
+
+    // Hands the latest published version of a graph from one writer to any number of readers.
+    template <class Payload>
+    class Graph_Publisher_T
+    {
+    public:
+
+        typedef Graph_Snapshot_T<Payload> Snapshot;
+        typedef typename Snapshot::Handle Handle;
+
+        Graph_Publisher_T()
+        {
+            versions = 0;
+        }
+
+        // Takes a snapshot of the given graph and makes it the current version. Called by the writer.
+        // Readers see either the previous version or the new one, never a partial edit.
+        Handle publish(Graph_T<Payload> * graph)
+        {
+            Handle snapshot = std::make_shared<const Snapshot>(graph, versions + 1);
+
+            std::lock_guard<std::mutex> guard(lock);
+            versions++;
+            latest = snapshot;
+            return snapshot;
+        }
+
+        // Returns the current version, or an empty handle if nothing was published yet.
+        // The version stays valid and unchanged for as long as the caller keeps the handle.
+        Handle current()
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            return latest;
+        }
+
+    private:
+
+        std::mutex lock;
+        Handle latest;
+
+        // The number of published versions, only changed by the writer.
+        uint64_t versions;
+    };
+
+}
@@ -1,6 +1,13 @@
 #pragma once
 
 #include "ofMain.h"
+#include <stdint.h>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <algorithm>
+#include <type_traits>
+#include "Index.h"
 
 /*
 * Halfedge Graph / Mesh class.
@@ -9,6 +16,34 @@
 *
 * 8/17/2016: Finished purely connectivist version with association.
 *
+* 10/17/2026: Elements are stored by value in one contiguous array per element type
+*             and link to each other by their 32 bit IDs, which are their indices within those arrays.
+*
+* 10/17/2026: The Graph and its elements are templates on a Payload policy, which names the associated data types.
+*             The data is stored inline within every element, rather than in a second heap object per element.
+*
+* 10/17/2026: The Graph owns all of its storage and frees it when deleted.
+*             reset() empties a Graph while keeping its capacity, so it may be reused for the next embedding.
+*
+* 10/17/2026: Elements are marked through caller owned Mark_Sets instead of a marked flag within every element.
+*             Clearing a Mark_Set takes constant time and queries that only read the Graph may run concurrently.
+*             Such queries use the const getters and iterators, which never write to the Graph, see Element_Array::read.
+*
+* 10/17/2026: IDs and links are scrib::Index values, 32 bit by default or 64 bit with SCRIB_64_BIT_INDICES. See Index.h.
+*
+* 10/17/2026: Added permute, which renumbers every element and rewrites every link, used to store the elements in spatial order.
+*
+* 10/17/2026: The element arrays may be attached to external memory, such as a mapped graph file, see attach and GraphFile.h.
+*
+* 10/17/2026: The element arrays are stored in chunks, which are shared copy on write by snapshots, see GraphSnapshot.h.
+*             Allocating an element no longer moves the other elements.
+*             Only the non-const getters copy shared chunks, so read only queries through a const Graph never change it.
+*
+* 10/17/2026: Elements may be removed, which leaves a tombstone with a NULL_ID ID that iterators skip, see removeFace.
+*
+* 10/17/2026: Tombstones may be filled by moving live elements into them, see moveFace, and dropped from the ends of the arrays,
+*             see trimRemoved, so that graphs may be compacted, see GraphMutator.h.
+*
 * Usage:
 *
 * The Application programmer / New Media Artist specifies the following:
@@ -31,43 +66,517 @@ namespace scrib
     // == Forward Declaration of classes.
 
     // -- Connectivity Elements.
+    // Every element is a template on a Payload policy class, which defines the following associated data types:
+    //
+    // struct Payload
+    // {
+    //     typedef ... Graph_Data;    // Stored on the heap, one per graph.
+    //     typedef ... Vertex_Data;   // Stored inline within every element of the matching type.
+    //     typedef ... Face_Data;     // Must be default constructible.
+    //     typedef ... Halfedge_Data;
+    //     typedef ... Edge_Data;
+    // };
+    //
+    // Applications only pay for the data that they use, any of the types may be Empty_Data.
+    // When the element data types hold no heap memory of their own, a Graph is only four chunked arrays and its Graph_Data,
+    // so deleting it frees one block per chunk rather than one per element, and resetting it frees nothing.
+    // See PolylineGraphData.h for the payload produced by the PolylineGraphEmbedder,
+    // which also defines the plain Graph, Vertex, Face, Halfedge and Edge names used throughout this addon.
 
     // Represents an entire planar graph embedding.
-    class Graph;
-    class Vertex;
-    class Face;
-    class Halfedge;
-    class Edge;
-
-    // Iterators for accessing the elements from the Graph object.
-    // FIXME: I may wish to use lists instead of vectors if I ever wish to delete objects.
-    // For now they are great because they allow random access to the elements by ID.
-    typedef   vector<Vertex *>::iterator   Vertex_Iter;
-    typedef   vector<Edge *>::iterator     Edge_Iter;
-    typedef   vector<Face *>::iterator     Face_Iter;
-    typedef   vector<Halfedge *>::iterator Halfedge_Iter;
-
-    // -- Associated Data.
-    // The classes will be defined in application specific files so that this halfedge mesh header file may be reused.
-    class Graph_Data;
-    class Vertex_Data;
-    class Face_Data;
-    class Halfedge_Data;
-    class Edge_Data;
+    template <class Payload> class Graph_T;
+    template <class Payload> class Vertex_T;
+    template <class Payload> class Face_T;
+    template <class Payload> class Halfedge_T;
+    template <class Payload> class Edge_T;
+
+    // Associated data for elements that do not need any.
+    struct Empty_Data
+    {
+    };
+
+    // Element IDs and NULL_ID are defined in Index.h.
+
+    // External memory holding the elements of a Graph, see Graph_T::attach.
+    // Deleting it releases the memory, e.g. unmaps a graph file.
+    class Graph_Storage
+    {
+    public:
+        virtual ~Graph_Storage() {}
+    };
+
+    // The elements of a type are stored in chunks of GRAPH_CHUNK_SIZE elements, which never move once allocated.
+    const size_t GRAPH_CHUNK_BITS = 10;
+    const size_t GRAPH_CHUNK_SIZE = (size_t)1 << GRAPH_CHUNK_BITS;
+    const size_t GRAPH_CHUNK_MASK = GRAPH_CHUNK_SIZE - 1;
+
+    // Chunked storage for the elements of one type.
+    // The table of chunks may be shared with snapshots, see share, and a chunk is copied the first time
+    // it is accessed through operator[] after it was shared, so snapshots cost constant time
+    // and every version only owns the chunks it touched.
+    // The chunks may also be attached to external memory, which is used in place.
+    template <class Element>
+    class Element_Array
+    {
+    public:
+
+        Element_Array()
+        {
+            blocks   = NULL;
+            count    = 0;
+            epoch    = 1;
+            attached = false;
+        }
+
+        // Returns the element for writing, copying its chunk first if it is shared.
+        Element & operator[](size_t index)
+        {
+            size_t chunk = index >> GRAPH_CHUNK_BITS;
+            if (stamps[chunk] != epoch)
+            {
+                own(chunk);
+            }
+
+            return blocks[chunk][index & GRAPH_CHUNK_MASK];
+        }
+
+        // Returns the element for reading, which never copies.
+        const Element & read(size_t index) const
+        {
+            return blocks[index >> GRAPH_CHUNK_BITS][index & GRAPH_CHUNK_MASK];
+        }
+
+        size_t size() const
+        {
+            return count;
+        }
+
+        bool isAttached() const
+        {
+            return attached;
+        }
+
+        void push_back(const Element & element)
+        {
+            if ((count >> GRAPH_CHUNK_BITS) == stamps.size())
+            {
+                add_chunk();
+            }
+
+            (*this)[count] = element;
+            count++;
+        }
+
+        // Allocates the chunks for the given number of elements, so that allocating them later allocates nothing.
+        void reserve(size_t size)
+        {
+            while (stamps.size() * GRAPH_CHUNK_SIZE < size)
+            {
+                add_chunk();
+            }
+        }
+
+        // Sets the number of elements, default constructing any new ones.
+        void resize(size_t size)
+        {
+            reserve(size);
+
+            for (size_t i = count; i < size; i++)
+            {
+                (*this)[i] = Element();
+            }
+
+            count = size;
+        }
+
+        // Removes every element. Keeps the chunks for reuse unless they are shared or attached.
+        void clear()
+        {
+            if (attached || (table && table.use_count() > 1))
+            {
+                table.reset();
+                blocks = NULL;
+                stamps.clear();
+                attached = false;
+            }
+
+            count = 0;
+        }
+
+        void swap(Element_Array & other)
+        {
+            std::swap(table,    other.table);
+            std::swap(blocks,   other.blocks);
+            std::swap(count,    other.count);
+            std::swap(stamps,   other.stamps);
+            std::swap(epoch,    other.epoch);
+            std::swap(attached, other.attached);
+        }
+
+        // Uses the given external elements in place, keeping the given storage alive for as long as any version uses them.
+        // Only the last chunk, which the external memory does not fill, is copied.
+        void attach(Element * external, size_t count, const std::shared_ptr<Graph_Storage> & storage)
+        {
+            table.reset();
+            blocks = NULL;
+            stamps.clear();
+            this -> count = 0;
+
+            size_t full = count >> GRAPH_CHUNK_BITS;
+            for (size_t chunk = 0; chunk < full; chunk++)
+            {
+                Element * block = external + (chunk << GRAPH_CHUNK_BITS);
+                add_chunk(block, std::shared_ptr<Element>(storage, block));
+            }
+
+            attached = full > 0;
+            this -> count = full << GRAPH_CHUNK_BITS;
+
+            for (size_t i = this -> count; i < count; i++)
+            {
+                push_back(external[i]);
+            }
+        }
+
+        // Makes the given array a version of this one, sharing every chunk. Takes constant time.
+        // Every chunk of this array is copied before it is next written, so the version never changes.
+        void share(Element_Array & version)
+        {
+            version.table    = table;
+            version.blocks   = blocks;
+            version.count    = count;
+            version.attached = attached;
+            version.stamps.clear();
+
+            epoch++;
+
+            // The epoch wrapped around, so old stamps could be mistaken for current ones.
+            if (epoch == 0)
+            {
+                std::fill(stamps.begin(), stamps.end(), 0);
+                epoch = 1;
+            }
+        }
+
+    private:
+
+        struct Chunk_Table
+        {
+            std::vector<Element *> blocks;
+
+            // Keep the chunks alive. Chunks attached to external memory share ownership of its storage.
+            std::vector<std::shared_ptr<Element> > owners;
+        };
+
+        // Makes sure that no other version uses the table, so it may be changed.
+        void own_table()
+        {
+            if (!table)
+            {
+                table = std::make_shared<Chunk_Table>();
+            }
+            else if (table.use_count() > 1)
+            {
+                table = std::make_shared<Chunk_Table>(*table);
+            }
+
+            blocks = table -> blocks.data();
+        }
+
+        // Makes the given chunk writable by this array, copying it if another version may read it.
+        void own(size_t chunk)
+        {
+            own_table();
+
+            std::shared_ptr<Element> & owner = table -> owners[chunk];
+
+            // Versions are only ever released, so a count of 1 stays 1.
+            // The fence orders the last reads of the released versions before the writes to the chunk.
+            if (owner.use_count() > 1)
+            {
+                Element * block = new Element[GRAPH_CHUNK_SIZE];
+                std::copy(blocks[chunk], blocks[chunk] + GRAPH_CHUNK_SIZE, block);
+                owner.reset(block, std::default_delete<Element[]>());
+                blocks[chunk] = block;
+            }
+            else
+            {
+                std::atomic_thread_fence(std::memory_order_acquire);
+            }
+
+            stamps[chunk] = epoch;
+        }
+
+        void add_chunk()
+        {
+            Element * block = new Element[GRAPH_CHUNK_SIZE];
+            add_chunk(block, std::shared_ptr<Element>(block, std::default_delete<Element[]>()));
+        }
+
+        void add_chunk(Element * block, const std::shared_ptr<Element> & owner)
+        {
+            own_table();
+            table -> blocks.push_back(block);
+            table -> owners.push_back(owner);
+            blocks = table -> blocks.data();
+            stamps.push_back(epoch);
+        }
+
+        std::shared_ptr<Chunk_Table> table;
+
+        // table -> blocks.data(), kept here to save an indirection per lookup.
+        Element ** blocks;
+        size_t count;
+
+        // A chunk may be written in place iff its stamp is the current epoch.
+        // share increments the epoch, so every chunk is owned again before it is written.
+        std::vector<uint32_t> stamps;
+        uint32_t epoch;
+
+        bool attached;
+
+        // Copies would share the chunks without copy on write, see share.
+        Element_Array(const Element_Array & other);
+        Element_Array & operator=(const Element_Array & other);
+    };
+
+    // Iterates over one of the arrays of elements in a Graph object, skipping removed elements.
+    // Dereferencing yields a pointer to the element, so (*iter) -> data works just like it did for arrays of pointers.
+    // Iterators over const elements only read the array, so they never copy a shared chunk.
+    template <class Value>
+    class Element_Iter
+    {
+        typedef typename std::remove_const<Value>::type Element;
+        typedef typename std::conditional<std::is_const<Value>::value,
+                                          const Element_Array<Element>, Element_Array<Element> >::type Array;
+
+    public:
+
+        Element_Iter(Array * array, size_t index)
+        {
+            this -> array = array;
+            this -> index = index;
+            skip_removed();
+        }
+
+        Value * operator*() const
+        {
+            return access(*array, index);
+        }
+
+        Element_Iter & operator++()
+        {
+            index++;
+            skip_removed();
+            return *this;
+        }
+
+        Element_Iter operator++(int)
+        {
+            Element_Iter output = *this;
+            ++(*this);
+            return output;
+        }
+
+        bool operator==(const Element_Iter & other) const
+        {
+            return index == other.index && array == other.array;
+        }
+
+        bool operator!=(const Element_Iter & other) const
+        {
+            return !(*this == other);
+        }
+
+    private:
+
+        void skip_removed()
+        {
+            while (index < array -> size() && array -> read(index).ID == NULL_ID)
+            {
+                index++;
+            }
+        }
+
+        static Element * access(Element_Array<Element> & array, size_t index)
+        {
+            return &array[index];
+        }
+
+        static const Element * access(const Element_Array<Element> & array, size_t index)
+        {
+            return &array.read(index);
+        }
+
+        Array * array;
+        size_t index;
+    };
 
     // FIXME: Clean up this prose.
 
     // -- Structural definition of classes.
-    // Every class is specified by its connectivity information and a pointer to associated user data.
+    // Every class is specified by its connectivity information and its associated user data.
 
     // All elements may be marked and unmarked by algorithms and users to specific sets of elements that meet various criteria.
+    // The marks are kept by the algorithm in a Mark_Set indexed by element ID, rather than within the Graph,
+    // so that every query has its own marks.
+    class Mark_Set
+    {
+    public:
+
+        Mark_Set()
+        {
+            epoch = 1;
+        }
+
+        // Unmarks every element and makes room for the IDs of the given number of elements.
+        // Takes constant time once the set has grown to the size of the graph.
+        void clear(size_t size)
+        {
+            epoch++;
+
+            // The epoch wrapped around, so old stamps could be mistaken for current ones.
+            if (epoch == 0)
+            {
+                std::fill(stamps.begin(), stamps.end(), 0);
+                epoch = 1;
+            }
+
+            if (stamps.size() < size)
+            {
+                stamps.resize(size, 0);
+            }
+        }
+
+        void mark(Index ID)
+        {
+            stamps[ID] = epoch;
+        }
+
+        void unmark(Index ID)
+        {
+            stamps[ID] = 0;
+        }
+
+        bool isMarked(Index ID)
+        {
+            return stamps[ID] == epoch;
+        }
+
+    private:
+
+        // An element is marked iff its stamp is the current epoch.
+        std::vector<uint32_t> stamps;
+        uint32_t epoch;
+    };
+
+    template <class Payload>
+    class Face_T
+    {
+    public:
+
+        Face_T()
+        {
+            halfedge = NULL_ID;
+            ID = NULL_ID;
+        }
+
+        // Representative from the interior loop of halfedges defining the boundary of the face.
+        Index halfedge;
+
+        typename Payload::Face_Data data;
+        Index ID;
+    };
+
+    template <class Payload>
+    class Vertex_T
+    {
+    public:
+
+        Vertex_T()
+        {
+            halfedge = NULL_ID;
+            ID = NULL_ID;
+        }
+
+        // A representative halfedge that is traveling away from this Vertex.
+        // getHalfedge(this -> halfedge) -> vertex = this -> ID.
+        Index halfedge;
+
+        typename Payload::Vertex_Data data;
+        Index ID;
+    };
+
+    // Non directed edges, very useful for getting consecutive ID's within input polylines.
+    template <class Payload>
+    class Edge_T
+    {
+    public:
+
+        Edge_T()
+        {
+            halfedge = NULL_ID;
+            ID = NULL_ID;
+        }
+
+        Index halfedge;
+
+        typename Payload::Edge_Data data;
+        Index ID;
+    };
+
+    // Every link is the ID of the linked element, which is looked up through the Graph, e.g. graph -> getHalfedge(halfedge -> next).
+    template <class Payload>
+    class Halfedge_T
+    {
+    public:
+
+        Halfedge_T()
+        {
+            twin = next = prev = NULL_ID;
+            face = edge = vertex = NULL_ID;
+            ID = NULL_ID;
+        }
+
+        Index twin;
+        Index next;
+        Index prev;
+
+        Index face;
+        Index edge;
+        Index vertex;
+
+        typename Payload::Halfedge_Data data;
+        Index ID;
+    };
 
     // The Graph class represents an entire graph embedding defined by points in space.
     // For the purposes of the facefinder, the output graph will be planar.
     // connected via edges that intersect only at vertices.
     // The FaceFinder class may be used to derive a Graph from a set of potentially intersecting input polylines.
-    class Graph
+    template <class Payload>
+    class Graph_T
     {
+    public:
+
+        typedef Face_T<Payload>     Face;
+        typedef Vertex_T<Payload>   Vertex;
+        typedef Edge_T<Payload>     Edge;
+        typedef Halfedge_T<Payload> Halfedge;
+
+        // Iterators for accessing the elements from the Graph object.
+        // FIXME: I may wish to use lists instead of vectors if I ever wish to delete objects.
+        // For now they are great because they allow random access to the elements by ID.
+        typedef Element_Iter<Vertex>   Vertex_Iter;
+        typedef Element_Iter<Edge>     Edge_Iter;
+        typedef Element_Iter<Face>     Face_Iter;
+        typedef Element_Iter<Halfedge> Halfedge_Iter;
+
+        // Iterators for read only queries, which never write to the Graph.
+        typedef Element_Iter<const Vertex>   Const_Vertex_Iter;
+        typedef Element_Iter<const Edge>     Const_Edge_Iter;
+        typedef Element_Iter<const Face>     Const_Face_Iter;
+        typedef Element_Iter<const Halfedge> Const_Halfedge_Iter;
 
         // Graph classes are where all of the actual data will be stored, so it contains vectors of valued data,
         // rather than pointers.
@@ -78,133 +587,387 @@ namespace scrib
 
     private:
 
-        // Note: We use pointers, because then the location on the heap for the elements is permanant.
-        std::vector<Face *>    faces;
-        std::vector<Vertex *>  vertices;
-        std::vector<Edge *>    edges;
-        std::vector<Halfedge*> halfedges;
+        // Each type of element is stored in chunks of contiguous elements, so walking the links between them stays within a few arrays.
+        Element_Array<Face>     faces;
+        Element_Array<Vertex>   vertices;
+        Element_Array<Edge>     edges;
+        Element_Array<Halfedge> halfedges;
+
+        // Snapshots share the element arrays.
+        template <class Snapshot_Payload> friend class Graph_Snapshot_T;
 
     public:
 
-        // Extra Application specific information.
-        Graph_Data * data;
+        Graph_T()
+        {
+            data = NULL;
+            removed_faces = removed_vertices = removed_edges = removed_halfedges = 0;
+        }
+
+        // Frees every element and the Graph_Data. Chunks shared with snapshots are freed with the last snapshot.
+        ~Graph_T()
+        {
+            delete data;
+        }
+
+        // Extra Application specific information, owned by this Graph.
+        typename Payload::Graph_Data * data;
+
+        // Removes every element, but keeps the allocated storage and the Graph_Data,
+        // so rebuilding a graph of a similar size allocates nothing.
+        // Releases the external storage of an attached graph, once no snapshot uses it.
+        void reset()
+        {
+            faces.clear();
+            vertices.clear();
+            edges.clear();
+            halfedges.clear();
+            removed_faces = removed_vertices = removed_edges = removed_halfedges = 0;
+        }
+
+        // Replaces the elements of this graph with the given external arrays, which are used in place without copying,
+        // and takes ownership of the storage holding them. The IDs and links of the elements must already be valid.
+        // The storage is deleted once neither this graph nor any snapshot of it uses the elements.
+        void attach(Vertex * vertices, size_t num_vertices, Edge * edges, size_t num_edges,
+                    Halfedge * halfedges, size_t num_halfedges, Face * faces, size_t num_faces, Graph_Storage * storage)
+        {
+            std::shared_ptr<Graph_Storage> shared(storage);
+
+            reset();
+            this -> vertices.attach(vertices, num_vertices, shared);
+            this -> edges.attach(edges, num_edges, shared);
+            this -> halfedges.attach(halfedges, num_halfedges, shared);
+            this -> faces.attach(faces, num_faces, shared);
+        }
+
+        // Returns true iff some of the elements of this graph are still in external storage.
+        bool isAttached()
+        {
+            return vertices.isAttached() || edges.isAttached() || halfedges.isAttached() || faces.isAttached();
+        }
 
         // -- Public Interface.
 
         // Allocation functions.
-        Face     * newFace();
-        Vertex   * newVertex();
-        Edge     * newEdge();
-        Halfedge * newHalfedge();
+        // Allocating an element never moves the other elements.
+        // WARNING: Taking a snapshot makes every element copy on write, so element pointers obtained before a snapshot
+        //          must not be written through after it. IDs are always valid.
+        Face * newFace()
+        {
+            Index ID = faces.size();
+            faces.push_back(Face());
+
+            Face * face = &faces[ID];
+            face -> ID = ID;
+            return face;
+        }
+
+        Vertex * newVertex()
+        {
+            Index ID = vertices.size();
+            vertices.push_back(Vertex());
+
+            Vertex * vertex = &vertices[ID];
+            vertex -> ID = ID;
+            return vertex;
+        }
+
+        Edge * newEdge()
+        {
+            Index ID = edges.size();
+            edges.push_back(Edge());
+
+            Edge * edge = &edges[ID];
+            edge -> ID = ID;
+            return edge;
+        }
+
+        Halfedge * newHalfedge()
+        {
+            Index ID = halfedges.size();
+            halfedges.push_back(Halfedge());
+
+            Halfedge * halfedge = &halfedges[ID];
+            halfedge -> ID = ID;
+            return halfedge;
+        }
+
+        // Reserves room for the given numbers of elements, so that allocating them allocates no memory.
+        void reserve(size_t num_vertices, size_t num_edges, size_t num_halfedges, size_t num_faces)
+        {
+            vertices.reserve(num_vertices);
+            edges.reserve(num_edges);
+            halfedges.reserve(num_halfedges);
+            faces.reserve(num_faces);
+        }
 
         // Accessing functions. We keep this interface, because then we only have to guranteed that the this.get(element.ID) = element.
         // We could even change the internal structure to a non contiguous lookup and the interface would be preserved.
+        // The non-const getters are for writing, and copy the element's chunk first if a snapshot shares it.
+
+        Face * getFace(Index ID)
+        {
+            return &faces[ID];
+        }
+
+        Vertex * getVertex(Index ID)
+        {
+            return &vertices[ID];
+        }
 
-        Face * getFace(int ID)
+        Edge * getEdge(Index ID)
         {
-            return faces[ID];
+            return &edges[ID];
         }
 
-        Vertex * getVertex(int ID)
+        Halfedge * getHalfedge(Index ID)
         {
-            return vertices[ID];
+            return &halfedges[ID];
         }
 
-        Edge * getEdge(int ID)
+        // The const getters are for reading, and never write to the Graph, so any number of threads may use them at once
+        // as long as nothing writes to the Graph.
+
+        const Face * getFace(Index ID) const
         {
-            return edges[ID];
+            return &faces.read(ID);
         }
 
-        Halfedge * getHalfedge(int ID)
+        const Vertex * getVertex(Index ID) const
         {
-            return halfedges[ID];
+            return &vertices.read(ID);
         }
 
-        size_t numFaces()
+        const Edge * getEdge(Index ID) const
+        {
+            return &edges.read(ID);
+        }
+
+        const Halfedge * getHalfedge(Index ID) const
+        {
+            return &halfedges.read(ID);
+        }
+
+        size_t numFaces() const
         {
             return faces.size();
         }
 
-        size_t numVertices()
+        size_t numVertices() const
         {
             return vertices.size();
         }
 
-        size_t numEdges()
+        size_t numEdges() const
         {
             return edges.size();
         }
 
         // Should theoretically be numEdges * 2.
-        size_t numHalfedges()
+        size_t numHalfedges() const
         {
             return halfedges.size();
         }
 
-        // -- Iteration functions.
+        // -- Removal.
 
-        Face_Iter facesBegin() { return faces.begin(); }
-        Face_Iter facesEnd() { return faces.end(); }
+        // Removing an element leaves a tombstone in its place, a default element whose ID is NULL_ID,
+        // so the IDs of the other elements stay the same and iterators skip it.
+        // The num functions above count tombstones, since they bound the IDs. Links to removed elements are up to the caller.
+        void removeFace(Index ID)
+        {
+            faces[ID] = Face();
+            removed_faces++;
+        }
 
-        Vertex_Iter verticesBegin() { return vertices.begin(); }
-        Vertex_Iter verticesEnd() { return vertices.end(); }
+        void removeVertex(Index ID)
+        {
+            vertices[ID] = Vertex();
+            removed_vertices++;
+        }
 
-        Edge_Iter edgesBegin() { return edges.begin(); }
-        Edge_Iter edgesEnd() { return edges.end(); }
+        void removeEdge(Index ID)
+        {
+            edges[ID] = Edge();
+            removed_edges++;
+        }
 
-        Halfedge_Iter halfedgesBegin() { return halfedges.begin(); }
-        Halfedge_Iter halfedgesEnd()   { return halfedges.end();   }
+        void removeHalfedge(Index ID)
+        {
+            halfedges[ID] = Halfedge();
+            removed_halfedges++;
+        }
 
-    };
+        // The numbers of tombstones.
+        size_t numRemovedFaces()     const { return removed_faces; }
+        size_t numRemovedVertices()  const { return removed_vertices; }
+        size_t numRemovedEdges()     const { return removed_edges; }
+        size_t numRemovedHalfedges() const { return removed_halfedges; }
 
-    class Face
-    {
-    public:
+        bool hasRemovedElements() const
+        {
+            return removed_faces + removed_vertices + removed_edges + removed_halfedges > 0;
+        }
 
-        // Representative from the interior loop of halfedges defining the boundary of the face.
-        Halfedge * halfedge;
+        // -- Compaction.
 
-        Face_Data * data;
-        int ID;
-    };
+        // Moves the element with ID from into the tombstone with ID to, which leaves a tombstone at from.
+        // Links to the element are up to the caller.
+        void moveFace(Index from, Index to)
+        {
+            faces[to] = faces[from];
+            faces[to].ID = to;
+            faces[from] = Face();
+        }
 
-    class Vertex
-    {
-    public:
+        void moveVertex(Index from, Index to)
+        {
+            vertices[to] = vertices[from];
+            vertices[to].ID = to;
+            vertices[from] = Vertex();
+        }
 
-        // A representative halfedge that is traveling away from this Vertex.
-        // this -> halfedge -> vertex = this.
-        Halfedge * halfedge;
+        void moveEdge(Index from, Index to)
+        {
+            edges[to] = edges[from];
+            edges[to].ID = to;
+            edges[from] = Edge();
+        }
 
-        Vertex_Data * data;
-        int ID;
-    };
+        void moveHalfedge(Index from, Index to)
+        {
+            halfedges[to] = halfedges[from];
+            halfedges[to].ID = to;
+            halfedges[from] = Halfedge();
+        }
 
-    // Non directed edges, very useful for getting consecutive ID's within input polylines.
-    class Edge
-    {
-    public:
+        // Drops the tombstones at the end of every array, which keeps their chunks for reuse.
+        // Takes time proportional to the number of tombstones dropped.
+        void trimRemoved()
+        {
+            removed_faces     -= trim(faces);
+            removed_vertices  -= trim(vertices);
+            removed_edges     -= trim(edges);
+            removed_halfedges -= trim(halfedges);
+        }
 
-        Halfedge * halfedge;
+        // -- Iteration functions.
 
-        Edge_Data * data;
-        int ID;
-    };
+        Face_Iter facesBegin() { return Face_Iter(&faces, 0); }
+        Face_Iter facesEnd() { return Face_Iter(&faces, faces.size()); }
 
+        Vertex_Iter verticesBegin() { return Vertex_Iter(&vertices, 0); }
+        Vertex_Iter verticesEnd() { return Vertex_Iter(&vertices, vertices.size()); }
 
-    class Halfedge
-    {
-    public:
+        Edge_Iter edgesBegin() { return Edge_Iter(&edges, 0); }
+        Edge_Iter edgesEnd() { return Edge_Iter(&edges, edges.size()); }
+
+        Halfedge_Iter halfedgesBegin() { return Halfedge_Iter(&halfedges, 0); }
+        Halfedge_Iter halfedgesEnd()   { return Halfedge_Iter(&halfedges, halfedges.size()); }
+
+        Const_Face_Iter facesBegin() const { return Const_Face_Iter(&faces, 0); }
+        Const_Face_Iter facesEnd()   const { return Const_Face_Iter(&faces, faces.size()); }
+
+        Const_Vertex_Iter verticesBegin() const { return Const_Vertex_Iter(&vertices, 0); }
+        Const_Vertex_Iter verticesEnd()   const { return Const_Vertex_Iter(&vertices, vertices.size()); }
+
+        Const_Edge_Iter edgesBegin() const { return Const_Edge_Iter(&edges, 0); }
+        Const_Edge_Iter edgesEnd()   const { return Const_Edge_Iter(&edges, edges.size()); }
+
+        Const_Halfedge_Iter halfedgesBegin() const { return Const_Halfedge_Iter(&halfedges, 0); }
+        Const_Halfedge_Iter halfedgesEnd()   const { return Const_Halfedge_Iter(&halfedges, halfedges.size()); }
+
+        // -- Renumbering.
+
+        // Moves every element to its new ID and rewrites every link between elements.
+        // Each array maps the old ID of an element of its type to its new ID, and must be a permutation of the IDs.
+        // Tombstones are moved as well and stay tombstones.
+        // IDs stored within the associated data are not known to the Graph, so the caller rewrites those.
+        void permute(const std::vector<Index> & vertex_IDs, const std::vector<Index> & edge_IDs,
+                     const std::vector<Index> & halfedge_IDs, const std::vector<Index> & face_IDs)
+        {
+            Element_Array<Vertex> new_vertices;
+            new_vertices.resize(vertices.size());
+            for (size_t i = 0; i < vertices.size(); i++)
+            {
+                Vertex & vertex = new_vertices[vertex_IDs[i]];
+                vertex = vertices.read(i);
+                vertex.ID = (vertex.ID == NULL_ID) ? NULL_ID : vertex_IDs[i];
+                vertex.halfedge = remap(halfedge_IDs, vertex.halfedge);
+            }
+
+            Element_Array<Edge> new_edges;
+            new_edges.resize(edges.size());
+            for (size_t i = 0; i < edges.size(); i++)
+            {
+                Edge & edge = new_edges[edge_IDs[i]];
+                edge = edges.read(i);
+                edge.ID = (edge.ID == NULL_ID) ? NULL_ID : edge_IDs[i];
+                edge.halfedge = remap(halfedge_IDs, edge.halfedge);
+            }
+
+            Element_Array<Halfedge> new_halfedges;
+            new_halfedges.resize(halfedges.size());
+            for (size_t i = 0; i < halfedges.size(); i++)
+            {
+                Halfedge & halfedge = new_halfedges[halfedge_IDs[i]];
+                halfedge = halfedges.read(i);
+                halfedge.ID     = (halfedge.ID == NULL_ID) ? NULL_ID : halfedge_IDs[i];
+                halfedge.twin   = remap(halfedge_IDs, halfedge.twin);
+                halfedge.next   = remap(halfedge_IDs, halfedge.next);
+                halfedge.prev   = remap(halfedge_IDs, halfedge.prev);
+                halfedge.face   = remap(face_IDs,     halfedge.face);
+                halfedge.edge   = remap(edge_IDs,     halfedge.edge);
+                halfedge.vertex = remap(vertex_IDs,   halfedge.vertex);
+            }
+
+            Element_Array<Face> new_faces;
+            new_faces.resize(faces.size());
+            for (size_t i = 0; i < faces.size(); i++)
+            {
+                Face & face = new_faces[face_IDs[i]];
+                face = faces.read(i);
+                face.ID = (face.ID == NULL_ID) ? NULL_ID : face_IDs[i];
+                face.halfedge = remap(halfedge_IDs, face.halfedge);
+            }
+
+            vertices.swap(new_vertices);
+            edges.swap(new_edges);
+            halfedges.swap(new_halfedges);
+            faces.swap(new_faces);
+        }
+
+        // Returns the new ID of the given old ID, links to no element stay NULL_ID.
+        static Index remap(const std::vector<Index> & new_IDs, Index ID)
+        {
+            return ID == NULL_ID ? NULL_ID : new_IDs[ID];
+        }
+
+    private:
+
+        // Drops the tombstones at the end of the given array and returns their number.
+        template <class Element>
+        static size_t trim(Element_Array<Element> & array)
+        {
+            size_t size = array.size();
+            while (size > 0 && array.read(size - 1).ID == NULL_ID)
+            {
+                size--;
+            }
+
+            size_t dropped = array.size() - size;
+            array.resize(size);
+            return dropped;
+        }
 
-        Halfedge * twin;
-        Halfedge * next;
-        Halfedge * prev;
+        size_t removed_faces;
+        size_t removed_vertices;
+        size_t removed_edges;
+        size_t removed_halfedges;
 
-        Face * face;
-        Edge * edge;
-        Vertex * vertex;
+        // Graphs own their Graph_Data, so they are not copied.
+        Graph_T(const Graph_T & other);
+        Graph_T & operator=(const Graph_T & other);
 
-        Halfedge_Data * data;
-        int ID;
     };
-}
\ No newline at end of file
+}
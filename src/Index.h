@@ -0,0 +1,37 @@
+#pragma once
+
+/*
+* Index type for points and graph elements.
+*
+* Written on 10/17/2026.
+*
+* Point indices, element IDs and the links between elements all use scrib::Index.
+* It is a 32 bit unsigned integer by default, which keeps the links between elements compact.
+* Define SCRIB_64_BIT_INDICES when building to use 64 bit indices for inputs with more than 2^32 - 1 points or halfedges.
+*
+* The embedders check that every index fits before building a graph, see fitsIndex.
+*/
+
+#include <stdint.h>
+#include <stddef.h>
+
+namespace scrib
+{
+
+#ifdef SCRIB_64_BIT_INDICES
+    typedef uint64_t Index;
+#else
+    typedef uint32_t Index;
+#endif
+
+    // The ID used to link to an element that does not exist, such as the face of a halfedge that has not been traced yet.
+    // It is the largest Index, so it is never the ID of an element.
+    const Index NULL_ID = (Index)-1;
+
+    // Returns true iff every one of the given number of elements may be given a distinct Index other than NULL_ID.
+    inline bool fitsIndex(size_t count)
+    {
+        return (uint64_t)count <= (uint64_t)NULL_ID;
+    }
+
+}
@@ -9,30 +9,936 @@
 
 #include <iostream>
 #include <math.h>
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+#include <limits>
+#include <thread>
+#include <atomic>
 #include "Intersector.h"
 
 namespace scrib {
 
     // Naive N^2 Intersection Algorithm.
-    void Intersector::intersect_brute_force(std::vector<scrib::Line> * lines)
+    // Cache blocked, so that each block of candidates stays in the cache while every line is tested against it.
+    void Intersector::intersect_brute_force(SegmentSoA * lines)
     {
+        // 512 candidates * 24 bytes fit comfortably inside of the L1 cache.
+        const int BLOCK_SIZE = 512;
+
+        SegmentSoA & segments = *lines;
+        std::vector<int> hits;
+
         int numLines = lines->size();
-        for (int a = 0; a < numLines; a++)
-            for (int b = a + 1; b < numLines; b++)
+        for (int block = 0; block < numLines; block += BLOCK_SIZE)
+        {
+            int block_end = min(block + BLOCK_SIZE, numLines);
+
+            for (int a = 0; a < block_end; a++)
             {
-                lines->at(a).intersect(&(lines->at(b)));
+                int start = max(a + 1, block);
+
+                hits.clear();
+                findCrossings(segments, a, start, block_end, hits);
+
+                for (size_t i = 0; i < hits.size(); i++)
+                {
+                    lines->intersect(a, hits[i]);
+                }
             }
+        }
     }
 
-    void Intersector::intersect(std::vector<scrib::Line> * lines)
+    void Intersector::intersect(SegmentSoA * lines, Intersection_Algorithm algorithm)
     {
-        EventPQ event_queue(lines);
+        switch (algorithm)
+        {
+        case BRUTE_FORCE:
+            intersect_brute_force(lines);
+            return;
+        case SWEEP_LINE:
+            intersect(lines);
+            return;
+        case PARALLEL_SWEEP_LINE:
+            intersect_parallel(lines);
+            return;
+        case UNIFORM_GRID:
+            intersect_grid(lines);
+            return;
+        case MONOTONE_CHAINS:
+            intersect_monotone_chains(lines);
+            return;
+        case POLYLINE_BVH:
+            intersect_bvh(lines);
+            return;
+        }
+    }
+
+    // Buckets the lines into a uniform grid and tests the pairs of lines that share a cell.
+    void Intersector::intersect_grid(SegmentSoA * lines)
+    {
+        int numLines = lines->size();
+
+        if (numLines < 2)
+        {
+            return;
+        }
+
+        // -- Determine the bounding box of the input and the mean line length.
+        float min_x = lines->min_x;
+        float min_y = lines->min_y;
+        float max_x = lines->max_x;
+        float max_y = lines->max_y;
+        float total_length = 0;
+
+        for (int i = 0; i < numLines; i++)
+        {
+            total_length += lines->length(i);
+        }
+
+        float width  = max_x - min_x;
+        float height = max_y - min_y;
+
+        // Cells are about as large as the average line, so that most lines only touch a few cells.
+        // Sparse inputs get larger cells, so that there are never many more cells than lines.
+        // Each side of the grid has at most about 2 sqrt(numLines) cells, even if the bounding box is nearly flat,
+        // e.g. for short horizontal strokes spread over a wide range.
+        float max_cells_per_side = sqrt(4.0f * numLines);
+        float cell_size = max(total_length / numLines, sqrt(width * height / (4.0f * numLines)));
+        cell_size = max(cell_size, max(width, height) / max_cells_per_side);
+
+        if (!(cell_size > 0))
+        {
+            cell_size = max(max(width, height), 1.0f);
+        }
+
+        // The cap also guards against rounding in the divisions.
+        int max_side = (int)max_cells_per_side + 1;
+        int grid_w = min((int)(width  / cell_size) + 1, max_side);
+        int grid_h = min((int)(height / cell_size) + 1, max_side);
+        size_t numCells = (size_t)grid_w * grid_h;
+
+        // -- Determine the range of cells overlapped by each line's bounding box.
+        // Stored as 4 consecutive integers per line: min x, min y, max x, max y.
+        std::vector<int> ranges(numLines * 4);
+
+        // Number of lines in each cell, then the starting offset of each cell.
+        std::vector<int> cell_starts(numCells + 1, 0);
+
+        for (int i = 0; i < numLines; i++)
+        {
+            int * range = &ranges[i * 4];
+
+            range[0] = min((int)((min(lines->x1[i], lines->x2[i]) - min_x) / cell_size), grid_w - 1);
+            range[1] = min((int)((min(lines->y1[i], lines->y2[i]) - min_y) / cell_size), grid_h - 1);
+            range[2] = min((int)((max(lines->x1[i], lines->x2[i]) - min_x) / cell_size), grid_w - 1);
+            range[3] = min((int)((max(lines->y1[i], lines->y2[i]) - min_y) / cell_size), grid_h - 1);
+
+            for (int y = range[1]; y <= range[3]; y++)
+            for (int x = range[0]; x <= range[2]; x++)
+            {
+                cell_starts[y * grid_w + x + 1]++;
+            }
+        }
+
+        for (size_t c = 0; c < numCells; c++)
+        {
+            cell_starts[c + 1] += cell_starts[c];
+        }
+
+        // -- Fill the cells with line indices. Each cell's lines end up in increasing order.
+        std::vector<int> cell_lines(cell_starts[numCells]);
+        std::vector<int> cell_fill(cell_starts.begin(), cell_starts.end() - 1);
+
+        for (int i = 0; i < numLines; i++)
+        {
+            int * range = &ranges[i * 4];
+
+            for (int y = range[1]; y <= range[3]; y++)
+            for (int x = range[0]; x <= range[2]; x++)
+            {
+                cell_lines[cell_fill[y * grid_w + x]++] = i;
+            }
+        }
+
+        // -- Copy the lines into a structure of arrays in cell order, so that each cell's lines are contiguous.
+        SegmentSoA segments;
+        segments.reserve(cell_lines.size());
+
+        for (size_t i = 0; i < cell_lines.size(); i++)
+        {
+            segments.push_back(*lines, cell_lines[i]);
+        }
+
+        std::vector<int> hits;
+
+        // -- Test every pair of lines within each cell.
+        for (int y = 0; y < grid_h; y++)
+        for (int x = 0; x < grid_w; x++)
+        {
+            int cell  = y * grid_w + x;
+            int start = cell_starts[cell];
+            int end   = cell_starts[cell + 1];
+
+            for (int i = start; i < end; i++)
+            {
+                hits.clear();
+                findCrossings(segments, i, i + 1, end, hits);
+
+                for (size_t h = 0; h < hits.size(); h++)
+                {
+                    int a = cell_lines[i];
+                    int b = cell_lines[hits[h]];
+
+                    int * range_a = &ranges[a * 4];
+                    int * range_b = &ranges[b * 4];
+
+                    // Pairs that share several cells are only reported in the first cell they share,
+                    // which is the cell containing the minimum corner of their overlapping ranges.
+                    if (max(range_a[0], range_b[0]) != x || max(range_a[1], range_b[1]) != y)
+                    {
+                        continue;
+                    }
+
+                    lines->intersect(a, b);
+                }
+            }
+        }
+    }
+
+    void Intersector::intersect_red_blue(SegmentSoA * red, SegmentSoA * blue, SegmentIndex & blue_index)
+    {
+        std::vector<Line_Pair> pairs;
+        std::vector<int> candidates;
+
+        int numRed = red->size();
+        for (int i = 0; i < numRed; i++)
+        {
+            candidates.clear();
+            blue_index.query(*red, i, candidates);
+
+            for (size_t c = 0; c < candidates.size(); c++)
+            {
+                pairs.push_back(Line_Pair(i, candidates[c]));
+            }
+        }
+
+        // Sorted, so that the split points do not depend on the layout of the index.
+        std::sort(pairs.begin(), pairs.end());
+
+        int len = pairs.size();
+        for (int i = 0; i < len; i++)
+        {
+            SegmentSoA::intersect(*red, pairs[i].first, *blue, pairs[i].second);
+        }
+    }
+
+    void SegmentIndex::build(SegmentSoA * lines)
+    {
+        clear();
+        add(lines, 0);
+    }
+
+    void SegmentIndex::add(SegmentSoA * lines, int first)
+    {
+        int numLines = lines->size();
+
+        if (!(cell_size > 0))
+        {
+            float total_length = 0;
+            for (int i = first; i < numLines; i++)
+            {
+                total_length += lines->length(i);
+            }
+
+            cell_size = numLines > first ? total_length / (numLines - first) : 0;
+
+            if (!(cell_size > 0))
+            {
+                cell_size = 1;
+            }
+        }
+
+        for (int i = first; i < numLines; i++)
+        {
+            float min_x = min(lines->x1[i], lines->x2[i]);
+            float min_y = min(lines->y1[i], lines->y2[i]);
+            float max_x = max(lines->x1[i], lines->x2[i]);
+            float max_y = max(lines->y1[i], lines->y2[i]);
+
+            boxes.push_back(min_x);
+            boxes.push_back(min_y);
+            boxes.push_back(max_x);
+            boxes.push_back(max_y);
+            visited.push_back(0);
+
+            int x1 = cellCoordinate(min_x);
+            int y1 = cellCoordinate(min_y);
+            int x2 = cellCoordinate(max_x);
+            int y2 = cellCoordinate(max_y);
+
+            for (int y = y1; y <= y2; y++)
+            for (int x = x1; x <= x2; x++)
+            {
+                cells[cellKey(x, y)].push_back(i);
+            }
+        }
+    }
+
+    void SegmentIndex::clear()
+    {
+        cells.clear();
+        boxes.clear();
+        visited.clear();
+        stamp = 0;
+    }
+
+    void SegmentIndex::query(SegmentSoA & lines, int position, std::vector<int> & candidates)
+    {
+        if (boxes.empty())
+        {
+            return;
+        }
+
+        // Start a new query, restarting the stamps when they wrap around.
+        stamp++;
+        if (stamp == 0)
+        {
+            std::fill(visited.begin(), visited.end(), 0);
+            stamp = 1;
+        }
+
+        float min_x = min(lines.x1[position], lines.x2[position]);
+        float min_y = min(lines.y1[position], lines.y2[position]);
+        float max_x = max(lines.x1[position], lines.x2[position]);
+        float max_y = max(lines.y1[position], lines.y2[position]);
+
+        int x1 = cellCoordinate(min_x);
+        int y1 = cellCoordinate(min_y);
+        int x2 = cellCoordinate(max_x);
+        int y2 = cellCoordinate(max_y);
+
+        for (int y = y1; y <= y2; y++)
+        for (int x = x1; x <= x2; x++)
+        {
+            std::unordered_map<int64_t, std::vector<int> >::iterator cell = cells.find(cellKey(x, y));
+
+            if (cell == cells.end())
+            {
+                continue;
+            }
+
+            std::vector<int> & cell_lines = cell->second;
+
+            for (size_t c = 0; c < cell_lines.size(); c++)
+            {
+                int index = cell_lines[c];
+
+                if (visited[index] == stamp)
+                {
+                    continue;
+                }
+
+                visited[index] = stamp;
+
+                float * box = &boxes[index * 4];
+                if (box[0] <= max_x && min_x <= box[2] && box[1] <= max_y && min_y <= box[3])
+                {
+                    candidates.push_back(index);
+                }
+            }
+        }
+    }
+
+    void Intersector::intersect_monotone_chains(SegmentSoA * lines)
+    {
+        std::vector<MonotoneChain> chains;
+        buildMonotoneChains(lines, chains);
+
+        // Sort the chains by their left edges, so that each chain only needs to look ahead
+        // at the chains that start before it ends.
+        std::vector<int> order(chains.size());
+        for (size_t i = 0; i < chains.size(); i++)
+        {
+            order[i] = i;
+        }
+
+        std::sort(order.begin(), order.end(), [&chains](int a, int b)
+        {
+            return chains[a].min_x < chains[b].min_x;
+        });
+
+        int numChains = chains.size();
+        for (int i = 0; i < numChains; i++)
+        {
+            MonotoneChain & a = chains[order[i]];
+
+            for (int j = i + 1; j < numChains; j++)
+            {
+                MonotoneChain & b = chains[order[j]];
+
+                // Every remaining chain starts to the right of this one.
+                if (b.min_x > a.max_x)
+                {
+                    break;
+                }
+
+                if (b.min_y > a.max_y || a.min_y > b.max_y)
+                {
+                    continue;
+                }
+
+                intersectChains(lines, a, b);
+            }
+        }
+    }
+
+    void Intersector::buildMonotoneChains(SegmentSoA * lines, std::vector<MonotoneChain> & chains)
+    {
+        int numLines = lines->size();
+
+        for (int i = 0; i < numLines; i++)
+        {
+            bool forward = lines->x1[i] < lines->x2[i];
+
+            // Continue the current chain if this line follows it along the polyline in the same direction.
+            // Chains must be strictly x monotone, otherwise lines within them could overlap,
+            // so vertical lines form chains of their own.
+            bool extend = false;
+            if (!chains.empty() && lines->x1[i] != lines->x2[i])
+            {
+                MonotoneChain & chain = chains.back();
+                int last = chain.last;
+                extend = chain.forward == forward && lines->x1[last] != lines->x2[last] && lines->i2[last] == lines->i1[i];
+            }
+
+            if (!extend)
+            {
+                MonotoneChain chain;
+                chain.first   = i;
+                chain.forward = forward;
+                chain.min_x   = lines->x1[i];
+                chain.max_x   = lines->x1[i];
+                chain.min_y   = lines->y1[i];
+                chain.max_y   = lines->y1[i];
+                chains.push_back(chain);
+            }
+
+            MonotoneChain & chain = chains.back();
+            chain.last  = i;
+            chain.min_x = min(chain.min_x, lines->x2[i]);
+            chain.max_x = max(chain.max_x, lines->x2[i]);
+            chain.min_y = min(chain.min_y, lines->y2[i]);
+            chain.max_y = max(chain.max_y, lines->y2[i]);
+        }
+    }
+
+    void Intersector::intersectChains(SegmentSoA * lines, MonotoneChain & a, MonotoneChain & b)
+    {
+        // Only the x range covered by both chains can contain crossings.
+        float overlap_min = max(a.min_x, b.min_x);
+        float overlap_max = min(a.max_x, b.max_x);
+
+        int len_a = a.size();
+        int len_b = b.size();
+        int pos_a = 0;
+        int pos_b = 0;
+
+        // Skip the lines to the left of the overlap.
+        while (pos_a < len_a && max(lines->x1[a.lineAt(pos_a)], lines->x2[a.lineAt(pos_a)]) < overlap_min)
+        {
+            pos_a++;
+        }
+
+        while (pos_b < len_b && max(lines->x1[b.lineAt(pos_b)], lines->x2[b.lineAt(pos_b)]) < overlap_min)
+        {
+            pos_b++;
+        }
+
+        // Every pair of lines with overlapping x ranges is visited once.
+        while (pos_a < len_a && pos_b < len_b)
+        {
+            int index_a = a.lineAt(pos_a);
+            int index_b = b.lineAt(pos_b);
+            float left_a  = min(lines->x1[index_a], lines->x2[index_a]);
+            float left_b  = min(lines->x1[index_b], lines->x2[index_b]);
+
+            // Past the overlap.
+            if (left_a > overlap_max || left_b > overlap_max)
+            {
+                return;
+            }
+
+            // Keep the reporting order consistent with the brute force algorithm.
+            if (index_a < index_b)
+            {
+                lines->intersect(index_a, index_b);
+            }
+            else
+            {
+                lines->intersect(index_b, index_a);
+            }
+
+            // Advance whichever line ends first.
+            float right_a = max(lines->x1[index_a], lines->x2[index_a]);
+            float right_b = max(lines->x1[index_b], lines->x2[index_b]);
+
+            if (right_a < right_b)
+            {
+                pos_a++;
+            }
+            else
+            {
+                pos_b++;
+            }
+        }
+    }
+
+    void Intersector::intersect_bvh(SegmentSoA * lines)
+    {
+        int numLines = lines->size();
+
+        std::vector<BVHNode> nodes;
+        nodes.reserve(numLines * 2);
+
+        // One tree per input polyline.
+        std::vector<int> roots;
+
+        int first = 0;
+        for (int i = 0; i < numLines; i++)
+        {
+            // The polyline ends when the next line does not continue from this one.
+            if (i + 1 == numLines || lines->i2[i] != lines->i1[i + 1])
+            {
+                roots.push_back(buildPolylineBVH(lines, first, i, nodes));
+                first = i + 1;
+            }
+        }
+
+        int numRoots = roots.size();
+        for (int i = 0; i < numRoots; i++)
+        {
+            intersectBVH(lines, nodes, roots[i]);
+
+            // The root boxes reject most pairs of polylines that never touch each other.
+            for (int j = i + 1; j < numRoots; j++)
+            {
+                intersectBVH(lines, nodes, roots[i], roots[j]);
+            }
+        }
+    }
+
+    int Intersector::buildPolylineBVH(SegmentSoA * lines, int first, int last, std::vector<BVHNode> & nodes)
+    {
+        // The current level of the tree, starting with the leaves.
+        std::vector<int> level;
+
+        for (int i = first; i <= last; i++)
+        {
+            BVHNode leaf;
+            leaf.min_x = min(lines->x1[i], lines->x2[i]);
+            leaf.max_x = max(lines->x1[i], lines->x2[i]);
+            leaf.min_y = min(lines->y1[i], lines->y2[i]);
+            leaf.max_y = max(lines->y1[i], lines->y2[i]);
+            leaf.first = i;
+            leaf.last  = i;
+            leaf.left  = -1;
+            leaf.right = -1;
+
+            level.push_back(nodes.size());
+            nodes.push_back(leaf);
+        }
+
+        // Pair up neighboring nodes until only the root remains.
+        while (level.size() > 1)
+        {
+            int len = level.size();
+            int next_len = 0;
+
+            for (int i = 0; i < len; i += 2)
+            {
+                // An odd node out moves up to the next level unchanged.
+                if (i + 1 == len)
+                {
+                    level[next_len++] = level[i];
+                    continue;
+                }
+
+                BVHNode & left  = nodes[level[i]];
+                BVHNode & right = nodes[level[i + 1]];
+
+                BVHNode parent;
+                parent.min_x = min(left.min_x, right.min_x);
+                parent.max_x = max(left.max_x, right.max_x);
+                parent.min_y = min(left.min_y, right.min_y);
+                parent.max_y = max(left.max_y, right.max_y);
+                parent.first = left.first;
+                parent.last  = right.last;
+                parent.left  = level[i];
+                parent.right = level[i + 1];
+
+                level[next_len++] = nodes.size();
+                nodes.push_back(parent);
+            }
+
+            level.resize(next_len);
+        }
+
+        return level[0];
+    }
+
+    void Intersector::intersectBVH(SegmentSoA * lines, std::vector<BVHNode> & nodes, int node)
+    {
+        if (nodes[node].isLeaf())
+        {
+            return;
+        }
+
+        int left  = nodes[node].left;
+        int right = nodes[node].right;
+
+        intersectBVH(lines, nodes, left);
+        intersectBVH(lines, nodes, right);
+        intersectBVH(lines, nodes, left, right);
+    }
+
+    void Intersector::intersectBVH(SegmentSoA * lines, std::vector<BVHNode> & nodes, int node_a, int node_b)
+    {
+        BVHNode & a = nodes[node_a];
+        BVHNode & b = nodes[node_b];
+
+        if (!a.overlaps(b))
+        {
+            return;
+        }
+
+        if (a.isLeaf() && b.isLeaf())
+        {
+            // Neighboring lines along the polyline are tested too, SegmentSoA::intersect decides whether they meet beyond their joint.
+            // Keep the reporting order consistent with the brute force algorithm.
+            if (a.first < b.first)
+            {
+                lines->intersect(a.first, b.first);
+            }
+            else
+            {
+                lines->intersect(b.first, a.first);
+            }
+
+            return;
+        }
+
+        // Descend into the larger node.
+        if (b.isLeaf() || (!a.isLeaf() && a.last - a.first >= b.last - b.first))
+        {
+            int left  = a.left;
+            int right = a.right;
+            intersectBVH(lines, nodes, left,  node_b);
+            intersectBVH(lines, nodes, right, node_b);
+        }
+        else
+        {
+            int left  = b.left;
+            int right = b.right;
+            intersectBVH(lines, nodes, node_a, left);
+            intersectBVH(lines, nodes, node_a, right);
+        }
+    }
+
+    void Intersector::intersect(SegmentSoA * lines)
+    {
+        std::vector<Line_Pair> pairs;
+
+        sweep(lines, NULL, std::numeric_limits<float>::max(), pairs);
+        reportPairs(lines, pairs);
+    }
+
+    void Intersector::intersect_parallel(SegmentSoA * lines)
+    {
+        int numLines = lines->size();
+
+        int numSlabs = num_threads > 0 ? num_threads : std::thread::hardware_concurrency();
+
+        // Not worth the threads.
+        if (numSlabs <= 1 || numLines < 1024)
+        {
+            intersect(lines);
+            return;
+        }
+
+        // -- Choose slab boundaries with balanced numbers of end point events.
+        std::vector<float> event_xs;
+        event_xs.reserve(numLines * 2);
+        for (int i = 0; i < numLines; i++)
+        {
+            event_xs.push_back(lines->x1[i]);
+            event_xs.push_back(lines->x2[i]);
+        }
+        std::sort(event_xs.begin(), event_xs.end());
+
+        // Slab s covers [boundaries[s], boundaries[s + 1]].
+        std::vector<float> boundaries(numSlabs + 1);
+        boundaries[0] = -std::numeric_limits<float>::max();
+        boundaries[numSlabs] = std::numeric_limits<float>::max();
+        for (int s = 1; s < numSlabs; s++)
+        {
+            boundaries[s] = event_xs[(size_t)event_xs.size() * s / numSlabs];
+        }
+
+        // -- Give each line to every slab that it touches.
+        std::vector< std::vector<int> > slab_lines(numSlabs);
+        for (int i = 0; i < numLines; i++)
+        {
+            float min_x = min(lines->x1[i], lines->x2[i]);
+            float max_x = max(lines->x1[i], lines->x2[i]);
+
+            for (int s = 0; s < numSlabs; s++)
+            {
+                if (min_x <= boundaries[s + 1] && max_x >= boundaries[s])
+                {
+                    slab_lines[s].push_back(i);
+                }
+            }
+        }
+
+        // -- Sweep the slabs independently.
+        // Each slab stops once its sweep line leaves the slab,
+        // so every crossing is found by the slabs containing its x coordinate.
+        std::vector< std::vector<Line_Pair> > slab_pairs(numSlabs);
+        std::atomic<int> next_slab(0);
+
+        auto worker = [&]()
+        {
+            for (int s = next_slab++; s < numSlabs; s = next_slab++)
+            {
+                sweep(lines, &slab_lines[s], boundaries[s + 1], slab_pairs[s]);
+            }
+        };
+
+        std::vector<std::thread> threads;
+        for (int t = 1; t < numSlabs; t++)
+        {
+            threads.push_back(std::thread(worker));
+        }
+
+        worker();
+
+        for (size_t t = 0; t < threads.size(); t++)
+        {
+            threads[t].join();
+        }
+
+        // -- Merge. Crossings found by several slabs are removed by reportPairs.
+        std::vector<Line_Pair> pairs;
+        for (int s = 0; s < numSlabs; s++)
+        {
+            pairs.insert(pairs.end(), slab_pairs[s].begin(), slab_pairs[s].end());
+        }
+
+        reportPairs(lines, pairs);
+    }
+
+    void Intersector::sweep(SegmentSoA * lines, std::vector<int> * subset, float max_x, std::vector<Line_Pair> & pairs)
+    {
+        SegmentSoA & segments = *lines;
+        EventPQ event_queue(lines, subset);
         TupleBST tuple_bst;
+        CrossingPQ crossings;
+
+        LineTuple * above;
+        LineTuple * below;
+
+        while (!event_queue.isEmpty() || !crossings.empty())
+        {
+            // Crossings are processed before end point events at the same location,
+            // because they are clamped to happen before either of their lines exit.
+            if (!crossings.empty() && (event_queue.isEmpty() ||
+                !sweep_before(event_queue.min().x, event_queue.min().y, crossings.top().x, crossings.top().y)))
+            {
+                Crossing crossing = crossings.top();
+                crossings.pop();
+
+                if (crossing.x > max_x)
+                {
+                    return;
+                }
+
+                // Stale crossings have already been processed or their lines are no longer neighbors.
+                // They will be rescheduled if the lines become neighbors again.
+                if (!tuple_bst.adjacent(crossing.lower, crossing.upper))
+                {
+                    continue;
+                }
 
-        int len = event_queue.size();
+                int a = crossing.lower -> index;
+                int b = crossing.upper -> index;
+                pairs.push_back(Line_Pair(min(a, b), max(a, b)));
 
+                tuple_bst.swapTuples(crossing.lower, crossing.upper);
+
+                // The lines have traded places, so they each have a new neighbor.
+                scheduleCrossing(tuple_bst.below(crossing.upper), crossing.upper, crossing.x, crossing.y, crossings, segments, pairs);
+                scheduleCrossing(crossing.lower, tuple_bst.above(crossing.lower), crossing.x, crossing.y, crossings, segments, pairs);
+                continue;
+            }
+
+            Event event = event_queue.delMin();
+
+            if (event.x > max_x)
+            {
+                return;
+            }
+
+            switch (event.type)
+            {
+            case Event::ENTER:
+
+                tuple_bst.addTuple(event.tuple1, &above, &below);
+                scheduleCrossing(below, event.tuple1, event.x, event.y, crossings, segments, pairs);
+                scheduleCrossing(event.tuple1, above, event.x, event.y, crossings, segments, pairs);
+                pairThrough(event.tuple1, event.x, event.y, tuple_bst, segments, pairs);
+                continue;
+
+            case Event::EXIT:
+
+                pairThrough(event.tuple1, event.x, event.y, tuple_bst, segments, pairs);
+                tuple_bst.removeTuple(event.tuple1, &above, &below);
+                scheduleCrossing(below, above, event.x, event.y, crossings, segments, pairs);
+                continue;
+            }
+        }
+
+    }
+
+    void Intersector::reportPairs(SegmentSoA * lines, std::vector<Line_Pair> & pairs)
+    {
+        std::sort(pairs.begin(), pairs.end());
+        pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+
+        int len = pairs.size();
         for (int i = 0; i < len; i++)
-            //while(!event_queue.isEmpty())
+        {
+            lines->intersect(pairs[i].first, pairs[i].second);
+        }
+    }
+
+    // An end point of a line, ordered by its coordinates.
+    struct End_Point
+    {
+        float x;
+        float y;
+        Index index;
+
+        bool operator<(const End_Point & other) const
+        {
+            if (x != other.x)
+            {
+                return x < other.x;
+            }
+
+            if (y != other.y)
+            {
+                return y < other.y;
+            }
+
+            return index < other.index;
+        }
+    };
+
+    // Returns -1, 0 or 1 for the direction of value from origin.
+    static inline int direction(float value, float origin)
+    {
+        return (value > origin) - (value < origin);
+    }
+
+    // Returns true iff the given lines meet anywhere other than at an end point index that they share.
+    // End points that only share their coordinates are not detected here, see isSimple.
+    static bool meets_improperly(SegmentSoA & lines, LineTuple * lower, LineTuple * upper)
+    {
+        if (lower == NULL || upper == NULL)
+        {
+            return false;
+        }
+
+        int a = lower -> index;
+        int b = upper -> index;
+
+        if (lines.crosses(a, b))
+        {
+            return true;
+        }
+
+        if (!lines.connected(a, b))
+        {
+            return false;
+        }
+
+        // Joined at both ends.
+        if ((lines.i1[a] == lines.i1[b] && lines.i2[a] == lines.i2[b]) ||
+            (lines.i1[a] == lines.i2[b] && lines.i2[a] == lines.i1[b]))
+        {
+            return true;
+        }
+
+        // Lines joined at one end overlap iff the far end of one is on the other line, in the same direction from the joint.
+        bool a_first = lines.i1[a] == lines.i1[b] || lines.i1[a] == lines.i2[b];
+        bool b_first = lines.i1[b] == lines.i1[a] || lines.i1[b] == lines.i2[a];
+
+        float joint_x = a_first ? lines.x1[a] : lines.x2[a];
+        float joint_y = a_first ? lines.y1[a] : lines.y2[a];
+        float far_ax  = a_first ? lines.x2[a] : lines.x1[a];
+        float far_ay  = a_first ? lines.y2[a] : lines.y1[a];
+        float far_bx  = b_first ? lines.x2[b] : lines.x1[b];
+        float far_by  = b_first ? lines.y2[b] : lines.y1[b];
+
+        return lines.side(a, far_bx, far_by) == 0 &&
+               direction(far_ax, joint_x) == direction(far_bx, joint_x) &&
+               direction(far_ay, joint_y) == direction(far_by, joint_y);
+    }
+
+    bool Intersector::isSimple(SegmentSoA * lines)
+    {
+        SegmentSoA & segments = *lines;
+        int numLines = lines->size();
+
+        // -- Every point may only be shared by the two lines joined at it, using the same point index.
+        std::vector<End_Point> end_points(numLines * 2);
+        for (int i = 0; i < numLines; i++)
+        {
+            End_Point start = {lines->x1[i], lines->y1[i], lines->i1[i]};
+            End_Point end   = {lines->x2[i], lines->y2[i], lines->i2[i]};
+            end_points[i * 2]     = start;
+            end_points[i * 2 + 1] = end;
+        }
+
+        std::sort(end_points.begin(), end_points.end());
+
+        int len = end_points.size();
+        for (int i = 1; i < len; i++)
+        {
+            End_Point & previous = end_points[i - 1];
+            End_Point & current  = end_points[i];
+
+            if (previous.x != current.x || previous.y != current.y)
+            {
+                continue;
+            }
+
+            // A point visited twice, or a joint of three or more lines.
+            if (previous.index != current.index || (i > 1 && end_points[i - 2].x == current.x && end_points[i - 2].y == current.y))
+            {
+                return false;
+            }
+        }
+
+        // -- Sweep. Until the first meeting the lines never cross, so their order along the sweep line never changes.
+        EventPQ event_queue(lines);
+        TupleBST tuple_bst;
+
+        LineTuple * above;
+        LineTuple * below;
+
+        while (!event_queue.isEmpty())
         {
             Event event = event_queue.delMin();
 
@@ -40,140 +946,369 @@ namespace scrib {
             {
             case Event::ENTER:
 
-                tuple_bst.addTuple(event.tuple1);
+                tuple_bst.addTuple(event.tuple1, &above, &below);
+
+                // Lines collinear with the new line may overlap it without being its neighbors, see pairThrough.
+                for (LineTuple * other = above; other != NULL; other = tuple_bst.above(other))
+                {
+                    if (meets_improperly(segments, event.tuple1, other))
+                    {
+                        return false;
+                    }
+
+                    if (!event.tuple1 -> collinear(other))
+                    {
+                        break;
+                    }
+                }
+
+                for (LineTuple * other = below; other != NULL; other = tuple_bst.below(other))
+                {
+                    if (meets_improperly(segments, other, event.tuple1))
+                    {
+                        return false;
+                    }
+
+                    if (!event.tuple1 -> collinear(other))
+                    {
+                        break;
+                    }
+                }
+
                 continue;
 
             case Event::EXIT:
 
-                tuple_bst.removeTuple(event.tuple1);
+                tuple_bst.removeTuple(event.tuple1, &above, &below);
+
+                if (meets_improperly(segments, below, above))
+                {
+                    return false;
+                }
+
                 continue;
             }
         }
 
+        return true;
+    }
+
+    void Intersector::scheduleCrossing(LineTuple * lower, LineTuple * upper, float sweep_x, float sweep_y, CrossingPQ & crossings,
+                                       SegmentSoA & segments, std::vector<Line_Pair> & pairs)
+    {
+        if (lower == NULL || upper == NULL)
+        {
+            return;
+        }
+
+        // Lines meeting at an end point are paired by pairThrough when the sweep reaches that end point.
+        if (!segments.crosses(lower -> index, upper -> index))
+        {
+            return;
+        }
+
+        int a = lower -> index;
+        int b = upper -> index;
+
+        // Lines only cross ahead of the sweep line if the upper one ends below the lower one.
+        // Otherwise they have already swapped places, or they merely touch at the upper line's exit point or are collinear.
+        // Either way there is nothing left to swap, so the crossing is recorded right away.
+        // Pairs recorded more than once are removed by reportPairs.
+        if (lower -> side(upper -> x2, upper -> y2) >= 0)
+        {
+            pairs.push_back(Line_Pair(min(a, b), max(a, b)));
+            return;
+        }
+
+        // Time coordinate of the crossing along line a. See SegmentSoA::report_crossing.
+        float adx = segments.x2[a] - segments.x1[a];
+        float ady = segments.y2[a] - segments.y1[a];
+        float bdx = segments.x2[b] - segments.x1[b];
+        float bdy = segments.y2[b] - segments.y1[b];
+        float dx  = segments.x1[b] - segments.x1[a];
+        float dy  = segments.y1[b] - segments.y1[a];
+        float det = bdx * ady - bdy * adx;
+        float u   = (dy * bdx - dx * bdy) / det;
+
+        Crossing crossing;
+        crossing.x = segments.x1[a] + adx * u;
+        crossing.y = segments.y1[a] + ady * u;
+        crossing.lower = lower;
+        crossing.upper = upper;
+
+        // Guard against round off, the crossing must happen while both lines are still on the sweep line.
+        LineTuple * first_exit = sweep_before(upper -> x2, upper -> y2, lower -> x2, lower -> y2) ? upper : lower;
+        if (sweep_before(first_exit -> x2, first_exit -> y2, crossing.x, crossing.y))
+        {
+            crossing.x = first_exit -> x2;
+            crossing.y = first_exit -> y2;
+        }
+
+        if (sweep_before(crossing.x, crossing.y, sweep_x, sweep_y))
+        {
+            crossing.x = sweep_x;
+            crossing.y = sweep_y;
+        }
+
+        crossings.push(crossing);
+    }
+
+    void Intersector::pairThrough(LineTuple * line_tuple, float x, float y, TupleBST & tuple_bst,
+                                  SegmentSoA & segments, std::vector<Line_Pair> & pairs)
+    {
+        // Lines of length 0 exit before they enter, see TupleBST::removeTuple.
+        if (!line_tuple -> active)
+        {
+            return;
+        }
+
+        int a = line_tuple -> index;
+
+        for (int direction = 0; direction < 2; direction++)
+        {
+            LineTuple * other = direction == 0 ? tuple_bst.above(line_tuple) : tuple_bst.below(line_tuple);
+
+            // Active lines through the point contain it, so only the orientation needs to be tested.
+            while (other != NULL && other -> side(x, y) == 0)
+            {
+                int b = other -> index;
+
+                if (segments.crosses(a, b))
+                {
+                    pairs.push_back(Line_Pair(min(a, b), max(a, b)));
+                }
+
+                other = direction == 0 ? tuple_bst.above(other) : tuple_bst.below(other);
+            }
+        }
     }
 
     // ============================================================
     // Event Priority Queue Methods.
     // -----------------------------
 
+    // Maps floats onto unsigned integers with the same ordering,
+    // so that they may be sorted by their bits.
+    static inline uint32_t sortable_float_bits(float f)
+    {
+        uint32_t bits;
+        memcpy(&bits, &f, sizeof(bits));
+
+        // Negative numbers have all of their bits flipped to reverse their order,
+        // positive numbers have their sign bit set to move them above the negative numbers.
+        return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+    }
+
+    // Key and index into the unsorted events.
+    struct EventKey
+    {
+        uint64_t key;
+        uint32_t index;
+    };
+
+    // Stable LSD radix sort, 8 bits at a time.
+    // Passes where every key has the same digit are skipped, which is common for the high bits.
+    static void radix_sort(std::vector<EventKey> & keys)
+    {
+        size_t len = keys.size();
+        std::vector<EventKey> buffer(len);
+
+        for (int shift = 0; shift < 64; shift += 8)
+        {
+            size_t counts[256] = { 0 };
+
+            for (size_t i = 0; i < len; i++)
+            {
+                counts[(keys[i].key >> shift) & 0xFF]++;
+            }
+
+            if (counts[(keys[0].key >> shift) & 0xFF] == len)
+            {
+                continue;
+            }
+
+            // Convert the counts into starting offsets.
+            size_t total = 0;
+            for (int digit = 0; digit < 256; digit++)
+            {
+                size_t count = counts[digit];
+                counts[digit] = total;
+                total += count;
+            }
+
+            for (size_t i = 0; i < len; i++)
+            {
+                buffer[counts[(keys[i].key >> shift) & 0xFF]++] = keys[i];
+            }
+
+            keys.swap(buffer);
+        }
+    }
+
     // -- Constructor.
-    EventPQ::EventPQ(std::vector<scrib::Line> * lines)
+    EventPQ::EventPQ(SegmentSoA * lines, std::vector<int> * subset)
     {
-        int len = lines->size();
+        int len = subset != NULL ? subset->size() : lines->size();
+
+        next = 0;
+        tuples.resize(len);
+
+        // Exit events are stored in the first half and enter events in the second half,
+        // so the stable sort puts exits before enters at the same point and then orders by line index.
+        std::vector<Event> unsorted(len * 2);
 
         for (int i = 0; i < len; i++)
         {
-            scrib::Line * line = &(lines->at(i));
+            int index = subset != NULL ? subset->at(i) : i;
 
-            Event enter;
-            Event exit;
+            Event & enter = unsorted[len + i];
+            Event & exit  = unsorted[i];
 
-            ofPoint p1 = line->p1;
-            ofPoint p2 = line->p2;
+            float x1 = lines->x1[index];
+            float y1 = lines->y1[index];
+            float x2 = lines->x2[index];
+            float y2 = lines->y2[index];
 
-            // Enter at least x coordinate.
-            // Exit at greatest x coordinate.
-            // We are assuming that there are no vertical lines.
-            if (p1.x < p2.x)
+            // Enter at the lexicographically least end point.
+            // Exit at greatest one. Vertical lines enter at their lower end point.
+            if (sweep_before(x1, y1, x2, y2))
             {
-                populateEvent(enter, exit, p1, p2, line);
+                populateEvent(enter, exit, x1, y1, x2, y2, &tuples[i], index);
             }
             else
             {
-                populateEvent(enter, exit, p2, p1, line);
+                populateEvent(enter, exit, x2, y2, x1, y1, &tuples[i], index);
             }
+        }
 
-            PQ.insert(enter);
-            PQ.insert(exit);
-
-            //cout << "ENTER EVENT Generated : " << enter.x << ", " << enter.y << endl;
-            //cout << "EXIT EVENT Generated : "  << exit.x  << ", " << exit.y  << endl;
+        if (len == 0)
+        {
+            return;
+        }
 
+        std::vector<EventKey> keys(len * 2);
+        for (int i = 0; i < len * 2; i++)
+        {
+            Event & event = unsorted[i];
+            keys[i].key = ((uint64_t)sortable_float_bits(event.x) << 32) | sortable_float_bits(event.y);
+            keys[i].index = i;
         }
 
-        //cout << endl;
+        radix_sort(keys);
+
+        events.reserve(len * 2);
+        for (int i = 0; i < len * 2; i++)
+        {
+            events.push_back(unsorted[keys[i].index]);
+        }
     }
 
-    void EventPQ::populateEvent(Event &enter, Event &exit, ofPoint &p1, ofPoint &p2, scrib::Line * line)
+    void EventPQ::populateEvent(Event &enter, Event &exit, float x1, float y1, float x2, float y2, LineTuple * line_tuple, int index)
     {
         enter.type = Event::ENTER;
         exit.type = Event::EXIT;
 
-        enter.x = p1.x;
-        enter.y = p1.y;
+        enter.x = x1;
+        enter.y = y1;
 
-        exit.x = p2.x;
-        exit.y = p2.y;
+        exit.x = x2;
+        exit.y = y2;
 
-        LineTuple * line_tuple = new LineTuple();
-        line_tuple->x = p1.x;
-        line_tuple->y = p1.y;
-        line_tuple->line = line;
-        line_tuple->slope = (p2.y - p1.y) / (p2.x - p1.x);
+        line_tuple->x = x1;
+        line_tuple->y = y1;
+        line_tuple->index = index;
+        line_tuple->x2 = x2;
+        line_tuple->y2 = y2;
 
         enter.tuple1 = line_tuple;
         exit.tuple1 = line_tuple;
     }
 
-    Event EventPQ::delMin()
-    {
-        set<Event>::iterator iter = PQ.begin();
-        Event output = *iter;
-        PQ.erase(iter);
-        return output;
-    }
-
-    bool EventPQ::isEmpty()
-    {
-        return PQ.empty();
-    }
-
 
     //=======================================================
     // Binary Search Tree Representing the lines currently crossing the sweep line.
     //--------------------------------
 
-    void TupleBST::addTuple(LineTuple * line_tuple)
+    void TupleBST::addTuple(LineTuple * line_tuple, LineTuple ** above, LineTuple ** below)
     {
+        TuplePosition position;
+        position.tuple = line_tuple;
 
-        set<LineTuple *>::iterator iter = bst.begin();
+        line_tuple -> position = bst.insert(position).first;
+        line_tuple -> active = true;
 
-        scrib::Line * line = line_tuple->line;
+        *above = this -> above(line_tuple);
+        *below = this -> below(line_tuple);
+    }
 
-        while (iter != bst.end())
+    void TupleBST::removeTuple(LineTuple * line_tuple, LineTuple ** above, LineTuple ** below)
+    {
+        // Not Found.
+        if (!line_tuple -> active)
         {
-            LineTuple * line_tuple = (*iter);
-            scrib::Line * other_line = line_tuple->line;
-            line->intersect(other_line);
-            iter++;
+            cout << "--Tuple Not Found!!! " << line_tuple->x << " " << line_tuple->y << " " << line_tuple->x2 << " " << line_tuple->y2 << endl;
+            *above = NULL;
+            *below = NULL;
+            return;
         }
 
-        bst.insert(line_tuple);
-        return;
+        *above = this -> above(line_tuple);
+        *below = this -> below(line_tuple);
 
+        bst.erase(line_tuple -> position);
+        line_tuple -> active = false;
     }
 
-    void TupleBST::removeTuple(LineTuple * line_tuple)
+    bool TupleBST::adjacent(LineTuple * lower, LineTuple * upper)
     {
+        if (!lower -> active || !upper -> active)
+        {
+            return false;
+        }
 
-        set<LineTuple *>::iterator iter = bst.find(line_tuple);
+        Tuple_Set::iterator iter = lower -> position;
+        iter++;
+
+        return iter == upper -> position;
+    }
+
+    void TupleBST::swapTuples(LineTuple * lower, LineTuple * upper)
+    {
+        Tuple_Set::iterator lower_position = lower -> position;
+        Tuple_Set::iterator upper_position = upper -> position;
+
+        lower_position -> tuple = upper;
+        upper_position -> tuple = lower;
+
+        lower -> position = upper_position;
+        upper -> position = lower_position;
+    }
+
+    LineTuple * TupleBST::above(LineTuple * line_tuple)
+    {
+        Tuple_Set::iterator iter = line_tuple -> position;
+        iter++;
 
-        // Not Found.
         if (iter == bst.end())
         {
-            cout << "--Tuple Not Found!!! " << line_tuple->x << " " << line_tuple->y << " " << line_tuple->slope << endl;
-            return;
+            return NULL;
         }
-        else
-        {
-            //cout << "--Tuple Exited: " << line_tuple->x << " " << line_tuple->y << " " << line_tuple->slope << endl;
-        }
-
-        bst.erase(iter);
 
+        return iter -> tuple;
     }
 
+    LineTuple * TupleBST::below(LineTuple * line_tuple)
+    {
+        Tuple_Set::iterator iter = line_tuple -> position;
 
-}
+        if (iter == bst.begin())
+        {
+            return NULL;
+        }
+
+        iter--;
+        return iter -> tuple;
+    }
 
 
+}
\ No newline at end of file
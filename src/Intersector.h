@@ -6,11 +6,26 @@
 *  Referenced: https://github.com/alexiswolfish/ofxSweepLine
 *
 *
-* Canonical scrib::Line objects are represented by LineTuple objects in a bst.
+* Canonical lines are represented by LineTuple objects in a bst.
 * Events along the sweep line are managed by a priority queue.
 *
+* 10/17/2026: Converted into a proper Bentley-Ottmann sweep.
+*             Lines are only tested against their neighbors along the sweep line,
+*             crossings are scheduled as events and the crossing lines swap places in the bst when the sweep passes them.
+*             Runs in O((n + k) log n) time for n lines and k intersections.
+*
+* 10/17/2026: Tuples are ordered with exact orientation tests instead of y coordinates at the sweep line.
+*             Events are ordered lexicographically by x, then y, so vertical lines enter at their lower end point.
+*             Vertical, collinear and touching lines no longer need the input to be randomly perturbed.
+*
+* 10/17/2026: Added red / blue intersection of a new set of lines against an indexed set of lines.
+*
+* 10/17/2026: Added a Shamos-Hoey sweep that only decides whether any lines meet.
+*
+* 10/17/2026: Every end point event pairs its line with all of the lines through that end point,
+*             not just with its neighbors and the lines collinear with it, which missed touches beyond a collinear run.
+*
 * This implementation should properly handle lines originating from the same end points.
-* This implementation assumes that no lines have the same slope and no lines are vertical.
 *
 * Note : Sets regard types as being equal when their cooresponding ordering operator returns false reflexively.
 */
@@ -21,10 +36,60 @@
 #include <math.h>
 #include <list>
 #include <set>
-#include "Line.h"
+#include <queue>
+#include <unordered_map>
+#include <stdint.h>
+#include "Segments.h"
+#include "SegmentKernel.h"
+#include "Predicates.h"
 
 namespace scrib {
 
+    // The algorithms availible for finding the intersection points between lines.
+    enum Intersection_Algorithm
+    {
+        // Naive N^2. Small constants. As robust as it gets.
+        BRUTE_FORCE,
+
+        // Bentley-Ottmann sweep line, O((n + k) log n).
+        SWEEP_LINE,
+
+        // The x range is split into slabs with balanced numbers of events, which are swept on separate threads.
+        // Produces exactly the same split points as SWEEP_LINE.
+        PARALLEL_SWEEP_LINE,
+
+        // Lines are bucketed into a uniform grid and only lines sharing a cell are tested.
+        // Best for lines of similar lengths, such as mouse input sampled at regular distances.
+        UNIFORM_GRID,
+
+        // Input polylines are cut into x monotone chains and only chains with overlapping bounding boxes are
+        // walked against each other. Best for long hand drawn strokes.
+        MONOTONE_CHAINS,
+
+        // A bounding volume hierarchy is built over each input polyline and the trees are traversed against each other.
+        // Best for sets of polylines that rarely touch each other.
+        POLYLINE_BVH
+    };
+
+    class LineTuple;
+
+    // The bst stores positions that are filled by tuples.
+    // When two lines cross, their tuples trade positions without disturbing the rest of the tree.
+    struct TuplePosition
+    {
+        mutable LineTuple * tuple;
+    };
+
+    // Used to impose an ordering for the tuples in the bst.
+    // Tuples are ordered by where their lines cross the current sweep line.
+    struct LineTupleCompare
+    {
+        // Returns true if e1 < e2.
+        bool operator()(const TuplePosition & e1, const TuplePosition & e2) const;
+    };
+
+    typedef std::set<TuplePosition, LineTupleCompare> Tuple_Set;
+
     // Line Tuples are stored in a binary search tree to
     // represent the lines currently crossing the sweep line.
     class LineTuple
@@ -34,47 +99,81 @@ namespace scrib {
 
         LineTuple()
         {
-            line = NULL;
+            active = false;
         }
 
-        // Used to correctly order the y tuples by y coordinate.
+        // The end point where the line enters the sweep, which is the lexicographically smaller one.
         float x;
         float y;
 
-        // The slope is mainly used to properly order lines originating from the same end point.
-        float slope;
+        // The end point where the line exits the sweep.
+        float x2;
+        float y2;
 
-        // Every LineTuple is associated with one line.
-        scrib::Line * line;
+        // Every LineTuple is associated with one line, at this index within the input lines.
+        int index;
+
+        // True while the line crosses the sweep line.
+        bool active;
+
+        // The position currently filled by this tuple. Only valid while active.
+        Tuple_Set::iterator position;
+
+        // Returns true iff this tuple entered the sweep no earlier than the other tuple.
+        bool entersAfter(const LineTuple * other) const
+        {
+            return x > other->x || (x == other->x && y >= other->y);
+        }
+
+        // Returns which side of this tuple's line the given point is on, 1 is above.
+        // Lines are directed from their entering to their exiting end point, so for vertical lines 1 is to the left.
+        int side(float px, float py) const
+        {
+            return orientation(x, y, x2, y2, px, py);
+        }
+
+        // Returns true iff both lines lie on the same infinite line.
+        bool collinear(const LineTuple * other) const
+        {
+            return side(other->x, other->y) == 0 && side(other->x2, other->y2) == 0;
+        }
     };
 
-    // Used to impose an ordering for the tuples in the bst.
-    struct LineTupleCompare
+    inline bool LineTupleCompare::operator()(const TuplePosition & p1, const TuplePosition & p2) const
     {
-        // Returns true if e1 < e2.
-        bool operator()(const LineTuple * e1, const LineTuple * e2) const
+        const LineTuple * e1 = p1.tuple;
+        const LineTuple * e2 = p2.tuple;
+
+        // Equal.
+        if (e1 == e2)
         {
+            return false;
+        }
 
-            // Equal.
-            if (e1 == e2)
-            {
-                return false;
-            }
+        // The tuple that entered later has its entering end point within the x range of the other line,
+        // so testing that point against the other line tells us which line is higher along the sweep line.
+        bool swapped = !e1 -> entersAfter(e2);
+        if (swapped)
+        {
+            std::swap(e1, e2);
+        }
 
-            if ((e1->y) < (e2->y))
-            {
-                return true;
-            }
+        int side = e2 -> side(e1 -> x, e1 -> y);
 
-            if ((e2->y) < (e1->y))
-            {
-                return false;
-            }
+        // Lines starting on the other line are ordered by where they will be once the sweep line moves past their common point.
+        if (side == 0)
+        {
+            side = e2 -> side(e1 -> x2, e1 -> y2);
+        }
 
-            // We want lines with greater slop to be higher in the bst.
-            return (e1->slope) < (e2->slope);
+        // Collinear lines.
+        if (side == 0)
+        {
+            return (e1 -> index < e2 -> index) != swapped;
         }
-    };
+
+        return (side < 0) != swapped;
+    }
 
 
     // The Binary Search Tree used to store the tuples.
@@ -83,16 +182,30 @@ namespace scrib {
 
     public:
 
-        TupleBST() {};
+        TupleBST(){};
         //virtual ~TupleBST(){};
 
         // IN the line_tuple.
-        // OUT : The tuples that are above and below.
-        void addTuple(LineTuple * line_tuple);
-        void removeTuple(LineTuple * line_tuple);
+        // OUT : The tuples that are above and below. NULL if there are none.
+        void addTuple(LineTuple * line_tuple, LineTuple ** above, LineTuple ** below);
+
+        // IN the line_tuple.
+        // OUT : The tuples that were above and below, which are now neighbors. NULL if there are none.
+        void removeTuple(LineTuple * line_tuple, LineTuple ** above, LineTuple ** below);
+
+        // Returns true iff upper is located directly above lower in the bst.
+        bool adjacent(LineTuple * lower, LineTuple * upper);
+
+        // Exchanges the positions of two adjacent tuples, whose lines cross at the sweep line.
+        // lower will be directly above upper afterwards.
+        void swapTuples(LineTuple * lower, LineTuple * upper);
+
+        // Returns the neighboring tuples along the sweep line. NULL if there are none.
+        LineTuple * above(LineTuple * line_tuple);
+        LineTuple * below(LineTuple * line_tuple);
 
     private:
-        set<LineTuple *, LineTupleCompare> bst;
+        Tuple_Set bst;
 
     };
 
@@ -117,84 +230,295 @@ namespace scrib {
 
     };
 
+    // All of the enter and exit events are known up front,
+    // so they are built once, radix sorted once and then scanned in order.
+    // Events are totally ordered by x, then y, then exits before enters, then by line index.
     class EventPQ
     {
     public:
 
-        struct EventCompare
-        {
-            // Returns true if e1 < e2.
-            bool operator()(const Event& e1, const Event& e2) const
-            {
-                // Equal.
-                if (e1.tuple1 == e2.tuple1 &&
-                    e1.type == e2.type)
-                {
-                    return false;
-                }
-
-                if (e1.x < e2.x) { return true; }
-                if (e2.x < e1.x) { return false; }
-                if (e1.y > e2.y) { return true; }
-                if (e2.y < e1.y) { return false; }
-
-                if ((e1.type == Event::EXIT) && (e2.type == Event::ENTER))
-                {
-                    return true;
-                }
-
-                if ((e1.type == Event::ENTER) && (e2.type == Event::EXIT))
-                {
-                    return false;
-                }
-
-                if ((e1.tuple1->slope) > (e2.tuple1->slope))
-                {
-                    return true;
-                }
-
-                if ((e1.tuple1->slope) < (e2.tuple1->slope))
-                {
-                    return true;
-                }
-
-
-                return false;
-            }
-        };
-
         // -- Constructor.
         // Takes a list of the initial lines and adds start and end events for each of them.
-        EventPQ(std::vector<scrib::Line> * lines);
+        // If a subset is given, only the lines at the listed indices are added.
+        EventPQ(SegmentSoA * lines, std::vector<int> * subset = NULL);
         virtual ~EventPQ() {};
 
-        std::set<Event, EventCompare> PQ;
+        Event delMin()
+        {
+            return events[next++];
+        }
+
+        Event min()
+        {
+            return events[next];
+        }
 
-        Event delMin();
-        bool isEmpty();
+        bool isEmpty()
+        {
+            return next == events.size();
+        }
 
         int size()
         {
-            return PQ.size();
+            return events.size() - next;
         }
 
     private:
 
-        void populateEvent(Event &enter, Event &exit, ofPoint &p1, ofPoint &p2, scrib::Line * line);
+        // The sorted events.
+        std::vector<Event> events;
+        // Index of the next event to be removed.
+        size_t next;
+
+        // One contiguous block of tuples, one for each line.
+        std::vector<LineTuple> tuples;
+
+        void populateEvent(Event &enter, Event &exit, float x1, float y1, float x2, float y2, LineTuple * line_tuple, int index);
 
     };
 
+    // Crossings found between neighboring lines, which will be processed once the sweep line reaches them.
+    // Returns true iff point 1 comes strictly before point 2 in the sweep order, x then y.
+    inline bool sweep_before(float x1, float y1, float x2, float y2)
+    {
+        return x1 < x2 || (x1 == x2 && y1 < y2);
+    }
+
+    class Crossing
+    {
+    public:
+
+        // Crossings are ordered lexicographically, just like the events.
+        float x;
+        float y;
+
+        // The tuples are listed in their order along the sweep line before the crossing.
+        LineTuple * lower;
+        LineTuple * upper;
+    };
+
+    struct CrossingCompare
+    {
+        // Returns true if e1 should come out of the queue after e2.
+        bool operator()(const Crossing& e1, const Crossing& e2) const
+        {
+            return sweep_before(e2.x, e2.y, e1.x, e1.y);
+        }
+    };
+
+    typedef std::priority_queue<Crossing, std::vector<Crossing>, CrossingCompare> CrossingPQ;
+
+    // A maximal run of consecutive polyline lines that all travel in the same x direction.
+    // Chains never intersect themselves, so only pairs of chains need to be tested.
+    class MonotoneChain
+    {
+    public:
+
+        // Indices of the first and last lines in the chain, following the polyline.
+        int first;
+        int last;
+
+        // True iff x increases along the polyline.
+        bool forward;
+
+        // Bounding box.
+        float min_x;
+        float max_x;
+        float min_y;
+        float max_y;
+
+        int size()
+        {
+            return last - first + 1;
+        }
+
+        // Returns the index of the line at the given position from the left of the chain.
+        int lineAt(int position)
+        {
+            return forward ? first + position : last - position;
+        }
+    };
+
+    // Bounding volume hierarchy node covering a consecutive range of lines along a polyline.
+    // Consecutive lines are spatially coherent, so the tree is built bottom up by pairing neighbors without any sorting.
+    class BVHNode
+    {
+    public:
+
+        // Bounding box.
+        float min_x;
+        float max_x;
+        float min_y;
+        float max_y;
+
+        // Indices of the first and last lines covered by this node.
+        int first;
+        int last;
+
+        // Indices of the child nodes, -1 for leaves.
+        int left;
+        int right;
+
+        bool isLeaf()
+        {
+            return left < 0;
+        }
+
+        bool overlaps(BVHNode & other)
+        {
+            return min_x <= other.max_x && other.min_x <= max_x &&
+                   min_y <= other.max_y && other.min_y <= max_y;
+        }
+    };
+
+    // A uniform hash grid over a set of lines, such as the lines already drawn on a canvas.
+    // The index may be kept between calls to Intersector::intersect_red_blue and extended as strokes are added to the set,
+    // so that the cost of each query depends on the length of the query and not on the size of the set.
+    class SegmentIndex
+    {
+    public:
+
+        // A cell size of 0 uses the mean length of the first lines indexed.
+        SegmentIndex(float cell_size = 0)
+        {
+            this -> cell_size = cell_size;
+            stamp = 0;
+        };
+        virtual ~SegmentIndex() {};
+
+        // Indexes the given lines, replacing any previously indexed lines.
+        void build(SegmentSoA * lines);
+
+        // Indexes the lines from index first to the end of the given lines,
+        // such as a stroke that has just been appended to the indexed lines.
+        // REQUIRES: first == size().
+        void add(SegmentSoA * lines, int first);
+
+        // Forgets every line, but keeps the cell size.
+        void clear();
+
+        // Number of lines indexed.
+        int size()
+        {
+            return boxes.size() / 4;
+        }
+
+        // Appends the index of every indexed line whose bounding box overlaps the bounding box of the given line.
+        // Each index is appended once, in no particular order.
+        void query(SegmentSoA & lines, int position, std::vector<int> & candidates);
+
+    private:
+
+        float cell_size;
+
+        // Line indices, keyed by the packed integer coordinates of their cells.
+        std::unordered_map<int64_t, std::vector<int> > cells;
+
+        // Stored as 4 consecutive floats per line: min x, min y, max x, max y.
+        std::vector<float> boxes;
+
+        // The query stamp that last visited each line, so that lines spanning several cells are only reported once.
+        std::vector<unsigned int> visited;
+        unsigned int stamp;
+
+        int cellCoordinate(float value)
+        {
+            return (int)floor(value / cell_size);
+        }
+
+        static int64_t cellKey(int x, int y)
+        {
+            return ((int64_t)x << 32) | (uint32_t)y;
+        }
+    };
+
+    // Indices of two crossing lines, smallest first.
+    typedef std::pair<int, int> Line_Pair;
+
     class Intersector
     {
 
     public:
-        Intersector() {};
+        Intersector()
+        {
+            num_threads = 0;
+        };
         virtual ~Intersector() {};
 
-        // Calls the Line::intersect method on all intersecting lines.
+        // Number of threads used by intersect_parallel. 0 uses every hardware thread.
+        void setNumThreads(int num_threads)
+        {
+            this -> num_threads = num_threads;
+        }
+
+        // Calls the SegmentSoA::intersect method on all intersecting lines.
         // Does not treat lines that intersect at common points as intersecting.
-        void intersect(std::vector<scrib::Line> * lines);
-        void intersect_brute_force(std::vector<scrib::Line> * lines);
+        // REQUIRES: The lines have been attached to a SplitBuffer, which collects the split points.
+        // Candidate pairs are tested with the batched SIMD kernel in SegmentKernel.h.
+        void intersect(SegmentSoA * lines);
+        void intersect_brute_force(SegmentSoA * lines);
+        void intersect_grid(SegmentSoA * lines);
+        void intersect_parallel(SegmentSoA * lines);
+        void intersect_monotone_chains(SegmentSoA * lines);
+        void intersect_bvh(SegmentSoA * lines);
+
+        // Intersects the lines using the given algorithm.
+        void intersect(SegmentSoA * lines, Intersection_Algorithm algorithm);
+
+        // Calls the SegmentSoA::intersect method on every intersecting pair of a red line and a blue line,
+        // such as a new stroke against the lines already on a canvas.
+        // Pairs of red lines and pairs of blue lines are not tested, the blue lines are assumed to already be intersected.
+        // Only the lines found by querying blue_index are tested, so the cost does not depend on the number of blue lines.
+        // REQUIRES: blue_index indexes exactly the blue lines and both sets of lines share the same global points.
+        //           Each set is attached to its own SplitBuffer, which may be kept along with the index.
+        void intersect_red_blue(SegmentSoA * red, SegmentSoA * blue, SegmentIndex & blue_index);
+
+        // Returns true iff no two lines meet, other than lines sharing an end point index at that end point.
+        // Points with identical coordinates but different indices count as meeting, as do lines overlapping at a joint.
+        // Shamos-Hoey sweep, only neighbors along the sweep line are tested and the sweep stops at the first meeting,
+        // so no crossings are ever processed. O(n log n) time. Does not modify the lines.
+        bool isSimple(SegmentSoA * lines);
+
+    private:
+
+        int num_threads;
+
+        // Sweeps the lines, or the given subset of them, from left to right and appends every pair of crossing lines.
+        // Stops once the sweep line passes max_x. Does not modify the lines, so slabs may be swept concurrently.
+        void sweep(SegmentSoA * lines, std::vector<int> * subset, float max_x, std::vector<Line_Pair> & pairs);
+
+        // Calls SegmentSoA::intersect once for each distinct pair in sorted order,
+        // so that the split points do not depend on the order in which the crossings were found.
+        void reportPairs(SegmentSoA * lines, std::vector<Line_Pair> & pairs);
+
+        // Schedules the crossing of the given neighboring tuples if their lines cross ahead of the sweep line.
+        // Crossings at or behind the sweep line are appended to pairs directly.
+        void scheduleCrossing(LineTuple * lower, LineTuple * upper, float sweep_x, float sweep_y, CrossingPQ & crossings,
+                              SegmentSoA & segments, std::vector<Line_Pair> & pairs);
+
+        // Pairs the given tuple with every line that it meets at the given end point of its line.
+        // Touching and collinear lines never swap, and the line touched may be separated from the tuple by other lines
+        // through the same point, e.g. a run of collinear lines, so they are not found by testing neighbors alone.
+        // Every active line through the point is contiguous with the tuple in the bst, so they are found by walking outwards
+        // from the tuple in both directions until a line misses the point.
+        void pairThrough(LineTuple * line_tuple, float x, float y, TupleBST & tuple_bst,
+                         SegmentSoA & segments, std::vector<Line_Pair> & pairs);
+
+        // Cuts the consecutive polylines within the lines into maximal x monotone chains.
+        void buildMonotoneChains(SegmentSoA * lines, std::vector<MonotoneChain> & chains);
+
+        // Walks two monotone chains from left to right like a merge, testing only the lines that overlap in x.
+        void intersectChains(SegmentSoA * lines, MonotoneChain & a, MonotoneChain & b);
+
+        // Builds a tree over the given range of consecutive lines and returns the index of its root node.
+        int buildPolylineBVH(SegmentSoA * lines, int first, int last, std::vector<BVHNode> & nodes);
+
+        // Finds the crossings between lines within the given subtree.
+        void intersectBVH(SegmentSoA * lines, std::vector<BVHNode> & nodes, int node);
+
+        // Finds the crossings between the lines of two subtrees.
+        // Lines joined at a common joint are tested as well, SegmentSoA::intersect decides whether they meet beyond it.
+        void intersectBVH(SegmentSoA * lines, std::vector<BVHNode> & nodes, int node_a, int node_b);
     };
 
 }
@@ -46,10 +46,58 @@ namespace scrib
 
         std::vector<ofPoint> * unpruned_output;
         unpruned_output = offsetCurve(input, dist);
-        std::vector<scrib::point_info> * pruned_output = computeExterior(unpruned_output);
+
+        // An offset curve without any loops is its own exterior, so the faces do not need to be found.
+        scrib::FaceFinder finder;
+        finder.setClosed(true);
+
+        std::vector<scrib::point_info> * pruned_output;
+        if (finder.isSimple(unpruned_output))
+        {
+            pruned_output = simpleExterior(unpruned_output);
+        }
+        else
+        {
+            pruned_output = computeExterior(unpruned_output);
+        }
+
+        delete unpruned_output;
+
         return pruned_output;
     }
 
+    std::vector<scrib::point_info> * OffsetCurves::simpleExterior(std::vector<ofPoint> * input)
+    {
+        std::vector<scrib::point_info> * output = new std::vector<scrib::point_info>();
+
+        // Indexed like the FaceFinder points, which skip repeated points.
+        int len = input->size();
+        for (int i = 0; i < len; i++)
+        {
+            ofPoint & point = input->at(i);
+
+            if (!output->empty() && output->back().point.x == point.x && output->back().point.y == point.y)
+            {
+                continue;
+            }
+
+            output->push_back(point_info(point, output->size()));
+        }
+
+        if (output->size() > 1 && output->back().point.x == output->front().point.x && output->back().point.y == output->front().point.y)
+        {
+            output->pop_back();
+        }
+
+        // The exterior face winds in the direction of positive area, see PolylineGraphPostProcessor::determineComplementedFaces.
+        if (scrib::computeAreaOfPolygon(output) <= 0)
+        {
+            std::reverse(output->begin(), output->end());
+        }
+
+        return output;
+    }
+
     std::vector<ofPoint> * OffsetCurves::offsetCurve(std::vector<ofPoint> * input, double dist)
     {
         std::vector<ofPoint> perp_dirs;
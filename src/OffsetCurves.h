@@ -3,7 +3,7 @@
 
 #include <vector>
 #include "ofMain.h"
-#include "Line.h"
+#include "Segments.h"
 #include "Intersector.h"
 #include "FaceFinder.h"
 
@@ -16,6 +16,8 @@
 * this computes the curve defined by all points at a signed distance d away form the curve.
 *
 * Features: A solution to the problem through a reduction to the external face of the planar graph segmentation.
+*
+* 10/17/2026: Offset curves without self intersections skip the segmentation entirely.
 */
 
 namespace scrib {
@@ -33,6 +35,9 @@ namespace scrib {
         // Takes a closed loop and returns the closed loop cooresponding to its exterior.
         std::vector<scrib::point_info> * computeExterior(std::vector<ofPoint> * inputs);
 
+        // Returns the given simple closed loop as its own exterior, oriented like the faces of computeExterior.
+        std::vector<scrib::point_info> * simpleExterior(std::vector<ofPoint> * inputs);
+
     };
 
 }
@@ -3,43 +3,141 @@
 namespace scrib
 {
 
-    void Graph_Data::clearFaceMarks()
+    void Chain_View::build(Graph * graph)
     {
-        for (Face_Iter iter = graph->facesBegin(); iter != graph->facesEnd(); iter++)
+        clear();
+
+        Index num_vertices  = graph -> numVertices();
+        Index num_halfedges = graph -> numHalfedges();
+
+        std::vector<Index> node_of_vertex(num_vertices, NULL_ID);
+        chain_of_halfedge.assign(num_halfedges, NULL_ID);
+
+        // Every vertex that does not have exactly 2 outgoing edges is a node.
+        // They are all known before any chain is traced, so that every chain stops at the first one.
+        for (Index i = 0; i < num_vertices; i++)
         {
-            (*iter) -> data -> marked = false;
+            Vertex_Data & data = graph -> getVertex(i) -> data;
+            if (data.isExtraordinary() || data.singleton_point)
+            {
+                add_node(i, node_of_vertex);
+            }
         }
-    }
 
-    void Graph_Data::clearVertexMarks()
-    {
-        for (Vertex_Iter iter = graph->verticesBegin(); iter != graph->verticesEnd(); iter++)
+        Index num_nodes = nodes.size();
+        for (Index node = 0; node < num_nodes; node++)
+        {
+            add_chains(graph, node, node_of_vertex);
+        }
+
+        // The remaining live halfedges are on loops of degree 2 vertices, which get one node each.
+        for (Index i = 0; i < num_halfedges; i++)
         {
-            (*iter) -> data -> marked = false;
+            if (chain_of_halfedge[i] == NULL_ID && graph -> getHalfedge(i) -> ID != NULL_ID)
+            {
+                add_node(graph -> getHalfedge(i) -> vertex, node_of_vertex);
+                add_chains(graph, nodes.size() - 1, node_of_vertex);
+            }
+        }
+
+        // Link the chains through the halfedges at their ends.
+        Index num_chains = halfedges.size();
+        for (Index i = 0; i < num_chains; i++)
+        {
+            Chain_Halfedge & chain = halfedges[i];
+            Halfedge * last = graph -> getHalfedge(chain.last);
+
+            chain.next = chain_of_halfedge[last -> next];
+            chain.twin = chain_of_halfedge[last -> twin];
+            halfedges[chain.next].prev = i;
+
+            Index current = chain.first;
+            for (Index j = 0; j < chain.length; j++)
+            {
+                Halfedge * halfedge = graph -> getHalfedge(current);
+                halfedge -> data.next_extraordinary = last -> next;
+                current = halfedge -> next;
+            }
         }
     }
 
-    void Graph_Data::clearEdgeMarks()
+    void Chain_View::add_node(Index vertex, std::vector<Index> & node_of_vertex)
     {
-        for (Edge_Iter iter = graph->edgesBegin(); iter != graph->edgesEnd(); iter++)
+        node_of_vertex[vertex] = nodes.size();
+
+        Chain_Node node = {vertex, NULL_ID};
+        nodes.push_back(node);
+    }
+
+    void Chain_View::add_chains(Graph * graph, Index node, std::vector<Index> & node_of_vertex)
+    {
+        Index start = graph -> getVertex(nodes[node].vertex) -> halfedge;
+        Index out   = start;
+
+        nodes[node].halfedge = halfedges.size();
+
+        // Go around the star of the node.
+        do
         {
-            (*iter) -> data -> marked = false;
-        }
+            Chain_Halfedge chain;
+            chain.first  = out;
+            chain.node   = node;
+            chain.face   = graph -> getHalfedge(out) -> face;
+            chain.twin   = chain.next = chain.prev = NULL_ID;
+            chain.length = 0;
+
+            Index ID = halfedges.size();
+
+            // Follow the chain until it reaches a node.
+            Index current = out;
+            while (true)
+            {
+                Halfedge * halfedge = graph -> getHalfedge(current);
+                chain_of_halfedge[current] = ID;
+                chain.length++;
+
+                Index target = graph -> getHalfedge(halfedge -> twin) -> vertex;
+                if (node_of_vertex[target] != NULL_ID)
+                {
+                    break;
+                }
+
+                current = halfedge -> next;
+            }
+
+            chain.last = current;
+            halfedges.push_back(chain);
+
+            out = graph -> getHalfedge(graph -> getHalfedge(out) -> twin) -> next;
+        } while (out != start);
     }
 
-    void Graph_Data::clearHalfedgeMarks()
+    void Chain_View::getPoints(const Graph * graph, Index chain, std::vector<ofPoint> & output)
     {
-        for (Halfedge_Iter iter = graph->halfedgesBegin(); iter != graph->halfedgesEnd(); iter++)
+        Chain_Halfedge & chain_halfedge = halfedges[chain];
+
+        Index current = chain_halfedge.first;
+        for (Index i = 0; i < chain_halfedge.length; i++)
         {
-            (*iter) -> data -> marked = false;
+            const Halfedge * halfedge = graph -> getHalfedge(current);
+            output.push_back(graph -> getVertex(halfedge -> vertex) -> data.point);
+            current = halfedge -> next;
         }
+
+        // The end node.
+        output.push_back(graph -> getVertex(graph -> getHalfedge(current) -> vertex) -> data.point);
     }
 
-    void Graph_Data::clearMarks()
+    void Chain_View::getFaceChains(const Graph * graph, Index face, std::vector<Index> & output)
     {
-        clearFaceMarks();
-        clearVertexMarks();
-        clearEdgeMarks();
-        clearHalfedgeMarks();
+        Index start   = chain_of_halfedge[graph -> getFace(face) -> halfedge];
+        Index current = start;
+
+        do
+        {
+            output.push_back(current);
+            current = halfedges[current].next;
+        } while (current != start);
     }
-}
\ No newline at end of file
+
+}
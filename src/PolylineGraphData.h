@@ -2,6 +2,23 @@
 
 #include "ofMain.h"
 #include "HalfedgeGraph.h"
+#include "GraphSnapshot.h"
+
+/*
+* Associated data for the Graphs produced by the PolylineGraphEmbedder.
+*
+* 10/17/2026: The element data is stored inline within the elements through the Polyline_Payload policy.
+*             The outgoing edges used during construction are now kept by the embedder instead of by every vertex.
+*
+* 10/17/2026: Removed the marked flags and the clear marks functions, algorithms keep their own Mark_Sets.
+*
+* 10/17/2026: Graph_Data records the original IDs of the elements of graphs relabeled in spatial order, see SpatialOrder.h.
+*
+* 10/17/2026: Graph_Data may keep the outgoing halfedges of every vertex in compressed sparse row form.
+*
+* 10/17/2026: Added the Chain_View, a compressed view of the graph with nodes only at intersection and tail vertices,
+*             which also fills in Halfedge_Data::next_extraordinary.
+*/
 
 namespace scrib
 {
@@ -12,45 +29,22 @@ namespace scrib
     class Halfedge_Data;
     class Edge_Data;
 
-    class Graph_Data
-    {
-    private: Graph * graph;
-
-    public:
-
-        Graph_Data(Graph * graph)
-        {
-            this -> graph = graph;
-        }
-
-        void clearFaceMarks();
-        void clearVertexMarks();
-        void clearEdgeMarks();
-        void clearHalfedgeMarks();
-
-        void clearMarks();
-
-    };
-
     class Face_Data
     {
-    private:
-        Face * face;
-
     public:
 
-        Face_Data(Face * face)
-        {
-            this -> face = face;
-        }
-
-        bool marked = false;
+        // The holes of a face form a list linked through the hole faces, so faces hold no heap memory.
+        // ID of the first hole face.
+        Index first_hole = NULL_ID;
 
-        std::vector<Face *> hole_representatives;
+        // ID of the next hole face of the face that this face is a hole of.
+        Index next_hole = NULL_ID;
 
-        void addHole(Face * hole)
+        // Adds the face with the given ID and data as a hole of this face.
+        void addHole(Index hole, Face_Data & hole_data)
         {
-            hole_representatives.push_back(hole);
+            hole_data.next_hole = first_hole;
+            first_hole = hole;
         }
 
         // The area of the face is determined by the intersection this face with all of the hole faces,
@@ -59,19 +53,9 @@ namespace scrib
 
     class Vertex_Data
     {
-    private:
-
-        Vertex * vertex;
-
     public:
 
-        Vertex_Data(Vertex * vertex)
-        {
-            this->vertex = vertex;
-        }
-
         ofPoint point;
-        bool marked = false;
 
         bool tail_point = false;
 
@@ -85,53 +69,209 @@ namespace scrib
         {
             return tail_point || intersection_point;
         }
-
-        // Used as a temporary structure for graph construction, but it is also may be relevant to users.
-        // I don't know whether I will maintain this structure outside of graph construction.
-        // FIXME: I might switch this to being a pointer to allow for me to null it out when no longer needed.
-        std::vector<Halfedge *> outgoing_edges;
     };
 
     class Edge_Data
     {
-    private:
-
-        // Halfedge Data members have pointers to their connectivity element.
-        Edge * edge;
+    };
 
+    class Halfedge_Data
+    {
     public:
 
-        Edge_Data(Edge * edge)
+        // The first halfedge after this one along its face that leaves a node of the Chain_View,
+        // i.e. the start of the next chain. NULL_ID until a Chain_View is built for the graph.
+        Index next_extraordinary = NULL_ID;
+
+        // A Halfedge will be labeled as extraordinary iff its vertex is an intersection point or a tail_point,
+        // see Vertex_Data::isExtraordinary.
+    };
+
+    // The associated data of the graphs built by the PolylineGraphEmbedder.
+    struct Polyline_Payload
+    {
+        typedef scrib::Graph_Data    Graph_Data;
+        typedef scrib::Vertex_Data   Vertex_Data;
+        typedef scrib::Face_Data     Face_Data;
+        typedef scrib::Halfedge_Data Halfedge_Data;
+        typedef scrib::Edge_Data     Edge_Data;
+    };
+
+    typedef Graph_T<Polyline_Payload> Graph;
+    typedef Graph::Vertex   Vertex;
+    typedef Graph::Face     Face;
+    typedef Graph::Halfedge Halfedge;
+    typedef Graph::Edge     Edge;
+
+    typedef Graph::Vertex_Iter   Vertex_Iter;
+    typedef Graph::Edge_Iter     Edge_Iter;
+    typedef Graph::Face_Iter     Face_Iter;
+    typedef Graph::Halfedge_Iter Halfedge_Iter;
+
+    typedef Graph::Const_Vertex_Iter   Const_Vertex_Iter;
+    typedef Graph::Const_Edge_Iter     Const_Edge_Iter;
+    typedef Graph::Const_Face_Iter     Const_Face_Iter;
+    typedef Graph::Const_Halfedge_Iter Const_Halfedge_Iter;
+
+    typedef Graph_Snapshot_T<Polyline_Payload>  Graph_Snapshot;
+    typedef Graph_Publisher_T<Polyline_Payload> Graph_Publisher;
+
+    // Relates the IDs of the elements of a relabeled graph to their original IDs, which follow the input order.
+    // Every array is empty if the graph has not been relabeled.
+    struct Graph_Permutation
+    {
+        // original_X[current ID] = original ID.
+        std::vector<Index> original_vertices;
+        std::vector<Index> original_edges;
+        std::vector<Index> original_halfedges;
+        std::vector<Index> original_faces;
+
+        // current_X[original ID] = current ID.
+        std::vector<Index> current_vertices;
+        std::vector<Index> current_edges;
+        std::vector<Index> current_halfedges;
+        std::vector<Index> current_faces;
+
+        bool empty()
+        {
+            return original_vertices.empty() && original_edges.empty() &&
+                   original_halfedges.empty() && original_faces.empty();
+        }
+
+        void clear()
+        {
+            original_vertices.clear();
+            original_edges.clear();
+            original_halfedges.clear();
+            original_faces.clear();
+            current_vertices.clear();
+            current_edges.clear();
+            current_halfedges.clear();
+            current_faces.clear();
+        }
+    };
+
+    // The outgoing halfedges of every vertex, sorted by angle, in compressed sparse row form.
+    // Empty unless requested with PolylineGraphEmbedder::setKeepOutgoingEdges.
+    struct Vertex_Stars
+    {
+        // The halfedges leaving the vertex with ID v are halfedges[offsets[v]] up to halfedges[offsets[v + 1]].
+        std::vector<Index> offsets;
+        std::vector<Index> halfedges;
+
+        bool empty()
+        {
+            return offsets.empty();
+        }
+
+        void clear()
         {
-            this->edge = edge;
+            offsets.clear();
+            halfedges.clear();
         }
 
-        bool marked = false;
+        size_t degree(Index vertex)
+        {
+            return offsets[vertex + 1] - offsets[vertex];
+        }
     };
 
-    class Halfedge_Data
+    // One chain of halfedges between two nodes of a Chain_View, standing in for all of them.
+    struct Chain_Halfedge
     {
+        // The first halfedge of the chain, which leaves the origin node, the last halfedge, which ends at the next node,
+        // and the number of halfedges in the chain. The halfedges of the chain are linked by their next links.
+        Index first;
+        Index last;
+        Index length;
+
+        // Links to other chain halfedges, which match the links of the halfedges at the ends of the chain.
+        Index twin;
+        Index next;
+        Index prev;
+
+        // The ID of the node that the chain leaves and the ID of the face of all of its halfedges.
+        Index node;
+        Index face;
+    };
 
-    private:
+    struct Chain_Node
+    {
+        Index vertex;
 
-        // Halfedge Data members have pointers to their connectivity element.
-        Halfedge * halfedge;
+        // The ID of a chain halfedge leaving this node.
+        Index halfedge;
+    };
 
+    /*
+    * A compressed view of a Graph, where every run of degree 2 vertices is collapsed into one chain.
+    * The nodes are the intersection, tail and singleton vertices, along with one vertex of every loop that has none of these,
+    * so that every halfedge belongs to exactly one chain.
+    * The faces are the faces of the Graph, so face tracing, face unions and dual graph algorithms may walk the chains,
+    * taking time proportional to the number of intersections rather than the number of input points.
+    * The full resolution points of a chain are found on demand with getPoints.
+    *
+    * A view is only valid until the graph is modified. relabelSpatially builds it again for the new IDs.
+    */
+    class Chain_View
+    {
     public:
 
-        Halfedge_Data(Halfedge * halfedge)
+        // Builds the view of the given graph and sets the next_extraordinary link of every halfedge.
+        // REQUIRES: The vertices have been classified by the PolylineGraphEmbedder.
+        void build(Graph * graph);
+
+        void clear()
         {
-            this->halfedge = halfedge;
+            nodes.clear();
+            halfedges.clear();
+            chain_of_halfedge.clear();
         }
 
+        bool empty()
+        {
+            return nodes.empty();
+        }
 
-        bool marked = false;
-        Halfedge * next_extraordinary = NULL;
+        // Appends the points of the given chain halfedge, from its origin node to its end node inclusive.
+        void getPoints(const Graph * graph, Index chain, std::vector<ofPoint> & output);
 
-        // A Halfedge will be labeled as extraordinary iff its vertex is an intersection point or a tail_point.
-        bool isExtraordinary()
+        // Appends the IDs of the chain halfedges around the given face, starting with the chain of face -> halfedge.
+        void getFaceChains(const Graph * graph, Index face, std::vector<Index> & output);
+
+        std::vector<Chain_Node> nodes;
+        std::vector<Chain_Halfedge> halfedges;
+
+        // The ID of the chain halfedge containing every halfedge of the graph.
+        std::vector<Index> chain_of_halfedge;
+
+    private:
+
+        // Adds the given vertex as a node.
+        void add_node(Index vertex, std::vector<Index> & node_of_vertex);
+
+        // Adds the chains leaving the given node, which end at the next vertices that are nodes.
+        void add_chains(Graph * graph, Index node, std::vector<Index> & node_of_vertex);
+    };
+
+    class Graph_Data
+    {
+    private: Graph * graph;
+
+    public:
+
+        Graph_Data(Graph * graph)
         {
-            return halfedge->vertex->data->isExtraordinary();
+            this -> graph = graph;
         }
+
+        // Filled in by relabelSpatially.
+        Graph_Permutation permutation;
+
+        // Filled in by the PolylineGraphEmbedder if requested.
+        Vertex_Stars stars;
+
+        // Built by the PolylineGraphEmbedder if requested, see PolylineGraphEmbedder::setChainView.
+        Chain_View chains;
     };
-}
\ No newline at end of file
+}
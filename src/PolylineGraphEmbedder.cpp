@@ -1,4 +1,5 @@
 #include "PolylineGraphEmbedder.h"
+#include <climits>
 
 namespace scrib {
 
@@ -9,8 +10,10 @@ namespace scrib {
 
     // FIXME: Allow for the embedding of multiple trivial subgraphs.
 
-    Graph * PolylineGraphEmbedder::embedPolylineSet(std::vector< std::vector<ofPoint> *> * inputs)
+    Graph * PolylineGraphEmbedder::embedPolylineSet(std::vector< std::vector<ofPoint> *> * inputs, Graph * output)
     {
+        recycled_graph = output;
+
         // Make sure that the previous data is cleared.
         int len = inputs->size();
         for (int i = 0; i < len; i++)
@@ -21,8 +24,10 @@ namespace scrib {
         return do_the_rest();
     }
 
-    Graph * PolylineGraphEmbedder::embedPolyline(std::vector<ofPoint> * inputs)
+    Graph * PolylineGraphEmbedder::embedPolyline(std::vector<ofPoint> * inputs, Graph * output)
     {
+        recycled_graph = output;
+
         // Handle Trivial Input.
         if (inputs->size() <= 1)
         {
@@ -32,6 +37,15 @@ namespace scrib {
         // Make sure that the previous data is cleared.
         loadInput(inputs);
 
+        // Every point was identical.
+        // The trivial graph is built before the cleanup, which forgets the given output graph.
+        if (lines_initial.empty())
+        {
+            Graph * output = trivial(inputs);
+            cleanup();
+            return output;
+        }
+
         return do_the_rest();
     }
 
@@ -45,49 +59,55 @@ namespace scrib {
         }
 
         // 1 point Graph.
+        graph -> reserve(1, 1, 2, 2);
 
         // We construct one of each element for the singleton graph.
-        // NOTE: This allocation is a wrapper on top of the Graph allocation function, which allocates its Vertex_Data object.
+        // NOTE: This allocation is a wrapper on top of the Graph allocation function, the Vertex_Data object is stored inline.
         //       the other functions this->new[ ____ ] work in the same way.
         Vertex * vertex = newVertex();
-        Vertex_Data * vertex_data = vertex -> data;
+        Vertex_Data & vertex_data = vertex -> data;
         Edge * edge = newEdge();
 
         Face * interior = newFace();
         Face * exterior = newFace();
-        Face_Data * interior_data = interior -> data;
-        Face_Data * exterior_data = exterior -> data;
+        Face_Data & interior_data = interior -> data;
+        Face_Data & exterior_data = exterior -> data;
 
         Halfedge * halfedge = newHalfedge();
         Halfedge * twin     = newHalfedge();// Somewhat fake, since singleton graphs are degenerate.
 
 
-        vertex_data->point = inputs -> at(0);
+        vertex_data.point = inputs -> at(0);
 
-        vertex -> halfedge = halfedge;
-        edge   -> halfedge = halfedge;
+        vertex -> halfedge = halfedge -> ID;
+        edge   -> halfedge = halfedge -> ID;
 
         // The interior is trivial and is defined by a trivial internal and external null area point boundary.
-        interior -> halfedge = halfedge;
-        interior_data -> addHole(exterior);
+        interior -> halfedge = halfedge -> ID;
+        interior_data.addHole(exterior -> ID, exterior_data);
 
-        exterior -> halfedge = halfedge;
+        exterior -> halfedge = halfedge -> ID;
 
         // Self referential exterior loop.
-        halfedge -> edge   = edge;
-        halfedge -> face   = exterior;
-        halfedge -> next   = halfedge;
-        halfedge -> prev   = halfedge;
-        halfedge -> twin   = twin;
-        halfedge -> vertex = vertex;
+        halfedge -> edge   = edge -> ID;
+        halfedge -> face   = exterior -> ID;
+        halfedge -> next   = halfedge -> ID;
+        halfedge -> prev   = halfedge -> ID;
+        halfedge -> twin   = twin -> ID;
+        halfedge -> vertex = vertex -> ID;
 
         // Self referential interior loop.
-        twin -> edge   = edge;
-        twin -> face   = interior;
-        twin -> next   = twin;
-        twin -> prev   = twin;
-        twin -> twin   = halfedge;
-        twin -> vertex = vertex;
+        twin -> edge   = edge -> ID;
+        twin -> face   = interior -> ID;
+        twin -> next   = twin -> ID;
+        twin -> prev   = twin -> ID;
+        twin -> twin   = halfedge -> ID;
+        twin -> vertex = vertex -> ID;
+
+        if (chain_view)
+        {
+            graph -> data -> chains.build(graph);
+        }
 
         return graph;
     }
@@ -95,40 +115,54 @@ namespace scrib {
     void PolylineGraphEmbedder::loadInput(std::vector<ofPoint> * inputs)
     {
         // Populate the original points.
-        int len = inputs -> size();
+        size_t len = inputs -> size();
 
         // The offset is the initial index of the first input point.
         // We can therefore load multiple input lines and keep the indices distinct.
-        int offset = points.size();
+        // Identical points that are not consecutive are merged after the intersection points have been found.
+        size_t offset = points.size();
 
-        for (int i = 0; i < len; i++)
+        for (size_t i = 0; i < len; i++)
         {
-            ofPoint input_point = inputs -> at(i) + ofPoint(ofRandomf(), ofRandomf());
+            ofPoint input_point = inputs -> at(i);
+
+            if (snap_rounding)
+            {
+                input_point = ofPoint(SnapRounder::snapCoordinate(input_point.x), SnapRounder::snapCoordinate(input_point.y));
+            }
 
-            // A Paranoid vertical line prevention technique.
-            if ((offset > 0 || i > 0) && points[offset + i - 1].x == input_point.x)
+            // Repeated points would form lines of length 0.
+            // The intersection predicates are exact, so the points do not need to be perturbed.
+            if (points.size() > offset && points.back().x == input_point.x && points.back().y == input_point.y)
             {
-                input_point.x += .001;
+                continue;
             }
 
             points.push_back(input_point);
         }
 
+        // Every input point was a repeat of the last point.
+        if (points.size() == offset)
+        {
+            return;
+        }
+
+        size_t last = points.size() - 1;
+
         // Populate the original lines.
-        for (int i = 0; i < len - 1; i++)
+        // Indices that do not fit in an Index are caught by indices_fit before the lines are used.
+        for (size_t i = offset; i < last; i++)
         {
-            lines_initial.push_back(scrib::Line(i + offset, i + offset + 1, &points));
+            lines_initial.push_back((Index)i, (Index)(i + 1));
         }
 
         // Add a line connecting the first and last points on the original set of input points if
-        // the face finder is in closed loop mode.
-        // In other words put a duplicate copy of the initial point.
-        if (closed_loop)
+        // the face finder is in closed loop mode, unless the input already ends where it started.
+        if (closed_loop && last > offset && !(points[last].x == points[offset].x && points[last].y == points[offset].y))
         {
-            // connects last point at index (len - 1 + offset) to the first point, located at index (0 + offset).
-            lines_initial.push_back(scrib::Line(len - 1 + offset, 0 + offset, &points));
+            // connects last point at index last to the first point, located at index offset.
+            lines_initial.push_back((Index)last, (Index)offset);
         }
-
     }
 
     inline Graph * PolylineGraphEmbedder::do_the_rest()
@@ -136,67 +170,108 @@ namespace scrib {
         // ASSUMPTION: Step 1. Input Loading has been acomplished.
         // We should have a list of indexed points and index associated edges.
 
-        splitIntersectionPoints();
+        if (!indices_fit() || !splitIntersectionPoints())
+        {
+            cleanup();
+            return NULL;
+        }
+
         allocate_graph_from_input();
         sort_outgoing_edges_by_angle();
         associate_halfedge_cycles();
 
         Graph * output = deriveFaces();
 
+        if (spatial_order)
+        {
+            relabelSpatially(output);
+        }
+
+        if (chain_view)
+        {
+            output -> data -> chains.build(output);
+        }
+
         cleanup();
 
         return output;
     }
 
-    void PolylineGraphEmbedder::splitIntersectionPoints()
+    bool PolylineGraphEmbedder::indices_fit()
     {
-        scrib::Intersector intersector;
+        // Every point becomes a vertex and every line becomes 2 halfedges. Positions of lines are ints.
+        size_t num_lines = max(lines_initial.size(), lines_split.size());
 
-        // Use a custom made O(maximum vertical overlap * log(maximum vertical overlap).
-        // Very small constant factors, cache friendly.
-        if (bUseFastAlgo)
+        if (fitsIndex(points.size()) && fitsIndex(num_lines * 2) && num_lines <= (size_t)INT_MAX)
         {
-            intersector.intersect(&lines_initial);
+            return true;
         }
-        else
+
+        cout << "Error: Too many points or lines for the index type, see Index.h." << endl;
+        return false;
+    }
+
+    bool PolylineGraphEmbedder::splitIntersectionPoints()
+    {
+        if (snap_rounding)
         {
-            // Naive brute force algo.
-            // N^2. Small constants. As robust as it gets.
-            intersector.intersect_brute_force(&lines_initial);
+            scrib::SnapRounder rounder;
+            rounder.setNumThreads(num_threads);
+            rounder.snapRound(&points, &lines_initial, algorithm);
+        }
+
+        scrib::Intersector intersector;
+        intersector.setNumThreads(num_threads);
+
+        // Every split point found is recorded in one shared buffer.
+        scrib::SplitBuffer splits;
+        splits.attach(&lines_initial);
+
+        // Uses the Bentley-Ottmann sweep line unless another Intersection_Algorithm was requested.
+        intersector.intersect(&lines_initial, algorithm);
+
+        // The crossing points are only merged and split into lines once all of their indices are known to fit.
+        if (!indices_fit())
+        {
+            return false;
         }
 
         // Populate the split sequence of lines.
         lines_split.clear();
 
-        int numLines = lines_initial.size();
-
         // Populates the list of edge disjoint lines that only intersect at vertices.
         // puts the edge in consecutive order following the input polylines.
-        for (int i = 0; i < numLines; i++)
-        {
-            scrib::Line line = lines_initial[i];
-            line.getSplitLines(&lines_split);
-        }
+        splits.getSplitLines(lines_initial, &lines_split);
+
+        // Lines crossing at a shared point each create a copy of it.
+        // Collinear overlapping lines and repeated input lines become identical lines after splitting.
+        mergeCoincidentPoints(&points, &lines_split);
+
+        // Splitting creates more lines than there were input lines.
+        return indices_fit();
     }
 
     void PolylineGraphEmbedder::allocate_graph_from_input()
     {
         graph = newGraph();
 
-        // -- Allocate all Vertices and their outgoing halfedge temporary structure.
-        int len = points.size();
-        for (int i = 0; i < len; i++)
+        // Every line becomes 1 edge and 2 halfedges, so the element arrays are allocated once.
+        graph -> reserve(points.size(), lines_split.size(), lines_split.size() * 2, 0);
+
+        // -- Allocate all Vertices.
+        Index len = points.size();
+        for (Index i = 0; i < len; i++)
         {
             Vertex * vert           = newVertex();
-            Vertex_Data * vert_data = vert -> data;
+            Vertex_Data & vert_data = vert -> data;
 
-            vert -> halfedge = NULL;
-            vert_data -> point = points[i];
+            vert -> halfedge = NULL_ID;
+            vert_data.point = points[i];
         }
 
         // -- Allocate 2 halfedges and 1 full edge for ever line in the split input.
         len = lines_split.size();
-        for (int i = 0; i < len; i++)
+        for (Index i = 0; i < len; i++)
         {
             newHalfedge();
             newHalfedge();
@@ -206,17 +281,14 @@ namespace scrib {
         // Associate edges <-> halfedges.
         //           halfedges <-> twin halfedges.
         //           halfedges <-> vertices.
-        Halfedge * last_forwards_halfedge = NULL;
-        Halfedge * last_backwards_halfedge = NULL;
-        int last_index = len * 2 - 1;
-        for (int i = 0; i < len; i++)
+        Index last_index = len * 2 - 1;
+        for (Index i = 0; i < len; i++)
         {
-            Line & line        = lines_split[i];
-            int vertex_ID      = line.p1_index;
-            int vertex_twin_ID = line.p2_index;
-            int edge_ID        = i;
-            int halfedge_ID    = i;             // Forwards halfedges with regards to the polyline.
-            int twin_ID        = last_index - i;// Backwards halfedges.
+            Index vertex_ID      = lines_split.i1[i];
+            Index vertex_twin_ID = lines_split.i2[i];
+            Index edge_ID        = i;
+            Index halfedge_ID    = i;             // Forwards halfedges with regards to the polyline.
+            Index twin_ID        = last_index - i;// Backwards halfedges.
 
             Edge     * edge      = graph -> getEdge(edge_ID);
             Halfedge * halfedge  = graph -> getHalfedge(halfedge_ID); // Forwards facing.
@@ -224,22 +296,19 @@ namespace scrib {
             Vertex   * vert      = graph -> getVertex(vertex_ID);
             Vertex   * vert_twin = graph -> getVertex(vertex_twin_ID);
 
-            Vertex_Data * vert_data      = vert -> data;
-            Vertex_Data * vert_twin_data = vert_twin -> data;
-
             // Edge <--> Halfedge.
-            edge -> halfedge = halfedge;
-            halfedge -> edge = edge;
-            twin     -> edge = edge;
+            edge -> halfedge = halfedge_ID;
+            halfedge -> edge = edge_ID;
+            twin     -> edge = edge_ID;
 
             // Halfedge <--> twin Halfedges.
-            halfedge -> twin = twin;
-            twin     -> twin = halfedge;
+            halfedge -> twin = twin_ID;
+            twin     -> twin = halfedge_ID;
 
             // Halfedge <--> Vertex.
 
-            halfedge -> vertex = vert;
-            twin     -> vertex = vert_twin;
+            halfedge -> vertex = vertex_ID;
+            twin     -> vertex = vertex_twin_ID;
 
             // Here we guranteed that Halfedge h->vertex->halfedge = h iff
             // the halfedge is the earliest halfedge originating from the vertex in the order.
@@ -247,40 +316,62 @@ namespace scrib {
             // FIXME: This no longer seems necessary, because of the outgoing edge structure.
             // Desired properties may be maintained at a later step.
 
-            if (vert -> halfedge == NULL)
+            if (vert -> halfedge == NULL_ID)
             {
-                vert -> halfedge = halfedge;
+                vert -> halfedge = halfedge_ID;
             }
 
-            if (vert_twin -> halfedge == NULL)
+            if (vert_twin -> halfedge == NULL_ID)
             {
-                vert_twin -> halfedge = twin;
+                vert_twin -> halfedge = twin_ID;
             }
 
-            // -- We store outgoing halfedges for each vertex in a temporary outgoing edges structure.
-            vert_data -> outgoing_edges.push_back(halfedge);
-            vert_twin_data -> outgoing_edges.push_back(twin);
         }
+
+        // -- We store outgoing halfedges for each vertex in a temporary compressed sparse row structure.
+        // Count the degrees, shifted by one so that the prefix sum turns them into the offsets of the following vertex.
+        Index num_points = points.size();
+        outgoing_offsets.assign(num_points + 1, 0);
+        for (Index i = 0; i < len; i++)
+        {
+            outgoing_offsets[lines_split.i1[i] + 1]++;
+            outgoing_offsets[lines_split.i2[i] + 1]++;
+        }
+
+        for (Index i = 0; i < num_points; i++)
+        {
+            outgoing_offsets[i + 1] += outgoing_offsets[i];
+        }
+
+        // Fill in line order, using the offsets as the next free slot of each vertex, then shift them back.
+        outgoing_edges.resize(len * 2);
+        for (Index i = 0; i < len; i++)
+        {
+            outgoing_edges[outgoing_offsets[lines_split.i1[i]]++] = i;
+            outgoing_edges[outgoing_offsets[lines_split.i2[i]]++] = last_index - i;
+        }
+
+        for (Index i = num_points; i > 0; i--)
+        {
+            outgoing_offsets[i] = outgoing_offsets[i - 1];
+        }
+
+        outgoing_offsets[0] = 0;
     }
 
     void PolylineGraphEmbedder::sort_outgoing_edges_by_angle()
     {
-        // Sort each outgoing edges list.
-        Vertex_Iter start = graph -> verticesBegin();
-        Vertex_Iter end   = graph -> verticesEnd();
-        for (Vertex_Iter iter = start; iter != end; iter++)
+        // Sort each vertex's slice of the outgoing edges.
+        Index len = outgoing_offsets.size() - 1;
+        for (Index i = 0; i < len; i++)
         {
-            Vertex_Data * vert_data = (*iter) -> data;
-            std::vector<Halfedge *> & outgoing_edges = vert_data -> outgoing_edges;
-            sort_outgoing_edges(outgoing_edges);
+            Index start = outgoing_offsets[i];
+            sort_outgoing_edges(outgoing_edges.data() + start, outgoing_offsets[i + 1] - start);
         }
     }
 
-    void PolylineGraphEmbedder::sort_outgoing_edges(std::vector<Halfedge * > & outgoing_edges)
+    void PolylineGraphEmbedder::sort_outgoing_edges(Index * outgoing_edges, int len)
     {
-        // Initialize useful information.
-        int len = outgoing_edges.size();
-
         // Less than 2 are already sorted, regardless of orientation.
         if (len <= 2)
         {
@@ -289,22 +380,23 @@ namespace scrib {
 
         // Note: len == 3 is sorted, but possibly of the wrong orientation.
 
-        std::vector<float> angles;
+        std::vector<float> & angles = outgoing_angles;
+        angles.clear();
 
         // Extract central information.
-        Halfedge    * outgoing_halfedge_representative = outgoing_edges[0];
-        Vertex      * center_vert  = outgoing_halfedge_representative -> vertex;
-        Vertex_Data * center_data  = center_vert -> data;
-        ofPoint       center_point = center_data -> point;
+        Halfedge    * outgoing_halfedge_representative = graph -> getHalfedge(outgoing_edges[0]);
+        Vertex      * center_vert  = graph -> getVertex(outgoing_halfedge_representative -> vertex);
+        Vertex_Data & center_data  = center_vert -> data;
+        ofPoint       center_point = center_data.point;
 
         // Populate the angles array with absolute relative angles.
-        for (auto iter = outgoing_edges.begin(); iter != outgoing_edges.end(); iter++)
+        for (int i = 0; i < len; i++)
         {
-            Halfedge * out = *iter;
-            Halfedge *  in = out -> twin;
-            Vertex * outer_vert = in -> vertex;
-            Vertex_Data * outer_data = outer_vert -> data;
-            ofPoint outer_point      = outer_data -> point;
+            Halfedge * out = graph -> getHalfedge(outgoing_edges[i]);
+            Halfedge *  in = graph -> getHalfedge(out -> twin);
+            Vertex * outer_vert = graph -> getVertex(in -> vertex);
+            Vertex_Data & outer_data = outer_vert -> data;
+            ofPoint outer_point      = outer_data.point;
 
             float angle = atan2(outer_point.y - center_point.y,
                 outer_point.x - center_point.x);
@@ -329,7 +421,7 @@ namespace scrib {
                 angles[i2] = angles[i1];
                 angles[i1] = temp_f;
 
-                Halfedge * temp_he = outgoing_edges[i2];
+                Index temp_he = outgoing_edges[i2];
                 outgoing_edges[i2] = outgoing_edges[i1];
                 outgoing_edges[i1] = temp_he;
             }
@@ -343,61 +435,68 @@ namespace scrib {
         Vertex_Iter end   = graph -> verticesEnd();
         for (Vertex_Iter vert = start; vert != end; vert++)
         {
-            Vertex_Data * vert_data           = (*vert) -> data;
-            vector<Halfedge *> outgoing_edges = vert_data -> outgoing_edges;
-            int degree = outgoing_edges.size();
+            Vertex_Data & vert_data = (*vert) -> data;
+            Index         first     = outgoing_offsets[(*vert) -> ID];
+            Index       * outgoing  = outgoing_edges.data() + first;
+            int degree = outgoing_offsets[(*vert) -> ID + 1] - first;
 
             // Singleton point.
             if (degree == 0)
             {
-                vert_data -> singleton_point = true;
+                vert_data.singleton_point = true;
 
-                Halfedge * halfedge = (*vert) -> halfedge;
+                Halfedge * halfedge = graph -> getHalfedge((*vert) -> halfedge);
                 // ASSERTION: halfedge != null. If construction the user inputs a graph with singleton points.
                 // FIXME: Perhaps I should allocate the half edge here for the trivial case. Maybe I should combine the
                 // places in my code where I define the singleton state.
 
-                halfedge -> next = halfedge;
-                halfedge -> prev = halfedge;
+                halfedge -> next = halfedge -> ID;
+                halfedge -> prev = halfedge -> ID;
                 continue;
             }
 
             // Tail vertex.
             if (degree == 1)
             {
-                vert_data -> tail_point = true;
+                vert_data.tail_point = true;
 
-                Halfedge * out = (*vert) -> halfedge;
-                Halfedge * in  = out  -> twin;
+                Halfedge * out = graph -> getHalfedge((*vert) -> halfedge);
+                Halfedge * in  = graph -> getHalfedge(out -> twin);
 
-                out -> prev = in;
-                in  -> next = out;
+                out -> prev = in  -> ID;
+                in  -> next = out -> ID;
                 continue;
             }
 
             // Mark junction points.
             if (degree > 2)
             {
-                vert_data -> intersection_point = true;
+                vert_data.intersection_point = true;
             }
 
             // Link the halfedge neighborhood.
             for (int i = 0; i < degree; i++)
             {
-                Halfedge * out = outgoing_edges[i];
-                Halfedge * in  = out -> twin;
+                Halfedge * out = graph -> getHalfedge(outgoing[i]);
+                Halfedge * in  = graph -> getHalfedge(out -> twin);
 
                 // This combined with the sort order determines the consistent orientation.
                 // I think that it defines a clockwise orientation, but I could be wrong.
                 
                 // FIXME: There is something wrong about this ordering.
 
-                in  -> next  = outgoing_edges[(i + 1) % degree];
-                out -> prev  = outgoing_edges[(i + degree - 1) % degree] -> twin;
+                in  -> next  = outgoing[(i + 1) % degree];
+                out -> prev  = graph -> getHalfedge(outgoing[(i + degree - 1) % degree]) -> twin;
             }
 
             continue;
         }
+
+        if (keep_outgoing_edges)
+        {
+            graph -> data -> stars.offsets.swap(outgoing_offsets);
+            graph -> data -> stars.halfedges.swap(outgoing_edges);
+        }
     }
 
     Graph * PolylineGraphEmbedder::deriveFaces()
@@ -405,43 +504,37 @@ namespace scrib {
 
         // For each halfedge, output its cycle once.
 
-        Halfedge_Iter start = graph -> halfedgesBegin();
-        Halfedge_Iter end   = graph -> halfedgesEnd();
+        Index len = graph -> numHalfedges();
 
         // Iterate through all originating points.
-        for (Halfedge_Iter halfedge = start; halfedge != end; halfedge++)
+        for (Index halfedge_ID = 0; halfedge_ID < len; halfedge_ID++)
         {
-            Halfedge_Data * halfedge_data = (*halfedge) -> data;
-
-            // Avoid previously traced cycles.
-            if (halfedge_data -> marked)
+            // Avoid previously traced cycles, whose halfedges already have a face.
+            if (graph -> getHalfedge(halfedge_ID) -> face != NULL_ID)
             {
                 continue;
             }
 
             Face * face = newFace(); // GraphEmbedder::newFace() ...
 
-            face -> halfedge = *halfedge;
+            face -> halfedge = halfedge_ID;
             trace_face(face);
         }
 
-        // Clear the marks.
-        graph -> data -> clearHalfedgeMarks();
-
         return this -> graph;
     }
 
     // Isn't this nice and conscise?
     void PolylineGraphEmbedder::trace_face(Face * face)
     {
-        Halfedge * start   = face -> halfedge;
-        Halfedge * current = start;
+        Index start   = face -> halfedge;
+        Index current = start;
 
         do
         {
-            current -> face = face;
-            current -> data -> marked = true;
-            current = current -> next;
+            Halfedge * halfedge = graph -> getHalfedge(current);
+            halfedge -> face = face -> ID;
+            current = halfedge -> next;
         } while (current != start);
     }
 
@@ -453,6 +546,7 @@ namespace scrib {
         points.clear();
         lines_initial.clear();
         lines_split.clear();
+        recycled_graph = NULL;
 
         // No dynamic allocated temporary structures! Wahoo!
     }
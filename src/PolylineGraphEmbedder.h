@@ -8,6 +8,16 @@
 * 8/16/2016: Written as a more fully advanced version of FaceFinder.h,
 *            which outputs sophisticated graph structures oozing with useful connectivity information.
 *
+* 10/17/2026: Added an integer snap rounding mode, where every output vertex is on the integer grid.
+*
+* 10/17/2026: Vertex and halfedge IDs are scrib::Index values. Inputs too large for the Index type are rejected.
+*
+* 10/17/2026: Added an optional spatial ordering pass, which relabels the output elements along a Hilbert curve.
+*
+* 10/17/2026: The outgoing halfedges of the vertices are built as one compressed sparse row array instead of a vector per vertex.
+*
+* 10/17/2026: Added an optional chain view of the output, see Chain_View in PolylineGraphData.h.
+*
 * Written for the STUDIO for Creative Inquiry at Carnegie Mellon University.
 */
 
@@ -54,10 +64,12 @@
 
 #include <vector>
 #include "ofMain.h"
-#include "Line.h"
+#include "Segments.h"
 #include "Intersector.h"
+#include "SnapRounding.h"
 #include "HalfedgeGraph.h"
 #include "PolylineGraphData.h"
+#include "SpatialOrder.h"
 
 namespace scrib {
 
@@ -71,8 +83,29 @@ namespace scrib {
         // but it kills the performance.
         PolylineGraphEmbedder(bool useFastAlgo = true)
         {
-            bUseFastAlgo = useFastAlgo;
+            algorithm = useFastAlgo ? SWEEP_LINE : BRUTE_FORCE;
+            closed_loop = false;
+            snap_rounding = false;
+            spatial_order = false;
+            keep_outgoing_edges = false;
+            chain_view = false;
+            num_threads = 0;
+            lines_initial.points = &points;
+            lines_split.points = &points;
+        };
+
+        // Finds the intersection points using the given algorithm.
+        PolylineGraphEmbedder(Intersection_Algorithm algorithm)
+        {
+            this -> algorithm = algorithm;
             closed_loop = false;
+            snap_rounding = false;
+            spatial_order = false;
+            keep_outgoing_edges = false;
+            chain_view = false;
+            num_threads = 0;
+            lines_initial.points = &points;
+            lines_split.points = &points;
         };
         virtual ~PolylineGraphEmbedder() {};
 
@@ -80,14 +113,56 @@ namespace scrib {
         // If close, it will consider endpoints as attached to each other.
         void setClosed(bool isClosed);
 
+        // Tells this embedder to round the input points to the integer grid and to snap round the intersection points,
+        // so that every output vertex has integer coordinates. See SnapRounding.h.
+        // Intended for integer pixel or tablet input. Coordinates are clamped to +-SnapRounder::COORDINATE_LIMIT.
+        void setSnapRounding(bool snap_rounding)
+        {
+            this -> snap_rounding = snap_rounding;
+        }
+
+        // Tells this embedder to keep the sorted outgoing halfedges of every vertex in graph -> data -> stars.
+        // They are discarded after construction by default.
+        void setKeepOutgoingEdges(bool keep_outgoing_edges)
+        {
+            this -> keep_outgoing_edges = keep_outgoing_edges;
+        }
+
+        // Tells this embedder to build the chain view of every output graph in graph -> data -> chains.
+        // The view has one node per intersection, tail or singleton vertex and one chain halfedge per run of degree 2 vertices.
+        void setChainView(bool chain_view)
+        {
+            this -> chain_view = chain_view;
+        }
+
+        // Tells this embedder to relabel the elements of the output graphs along a Hilbert curve, see SpatialOrder.h.
+        // Speeds up repeated traversals of large graphs. The input order IDs are kept in graph -> data -> permutation,
+        // but the ordering invariants of the IDs listed at the top of this file no longer hold.
+        void setSpatialOrder(bool spatial_order)
+        {
+            this -> spatial_order = spatial_order;
+        }
+
+        // Sets the number of threads used by the PARALLEL_SWEEP_LINE algorithm.
+        // 0, the default, uses every hardware thread.
+        void setNumThreads(int num_threads)
+        {
+            this -> num_threads = num_threads;
+        }
+
         // Derives a planar graph embedding from the given input polyline.
         // The input will be interpretted as open or closed depending on the value of this.closed_loop;
-        // Assumes all points are distinct.
-        // Offsets all input points by a small random amount to prevent degeneracies from vertical edges.
-        Graph * embedPolyline(std::vector<ofPoint> * inputs);
+        // Identical points are merged into a single vertex.
+        // Vertical, collinear and touching lines are handled exactly, so the points are used as is.
+        // If an output graph is given, it is reset and the embedding is built in it, reusing its storage, and it is returned.
+        // Otherwise a new graph is allocated, which the caller deletes.
+        // Returns NULL if the embedding has too many points or halfedges for scrib::Index, see Index.h.
+        // A given output graph is then left as it was and still belongs to the caller.
+        Graph * embedPolyline(std::vector<ofPoint> * inputs, Graph * output = NULL);
 
         // Derive faces from a set list of vertex disjoint polyline inputs.
-        Graph * embedPolylineSet(std::vector< std::vector<ofPoint> *> * inputs);
+        // The output graph and the return value are handled as in embedPolyline.
+        Graph * embedPolylineSet(std::vector< std::vector<ofPoint> *> * inputs, Graph * output = NULL);
 
     protected:
     private:
@@ -97,8 +172,13 @@ namespace scrib {
         inline Graph * trivial(std::vector<ofPoint> * inputs);
         inline Graph * do_the_rest();
 
-        bool bUseFastAlgo;
+        Intersection_Algorithm algorithm;
         bool closed_loop;
+        bool snap_rounding;
+        bool spatial_order;
+        bool keep_outgoing_edges;
+        bool chain_view;
+        int num_threads;
 
         // -- Step 1. Compute canonical input structures.
 
@@ -106,33 +186,48 @@ namespace scrib {
         // followed by the data structures that they have built.
 
         // Appends the given input points to the collated single input point array.
-        // Performs point fudging to avoid degenerate behavior.
+        // Drops repeated points, which would form lines of length 0.
         // Starts up the indexed collection of points.
         void loadInput(std::vector<ofPoint> * inputs);
 
         // The canonical collection of points at their proper indices.
         std::vector<ofPoint> points;
         // The original input lines.
-        std::vector<scrib::Line> lines_initial;
+        scrib::SegmentSoA lines_initial;
 
         // -- Step 2. Find intersections in the input and compute the embedded polyline structure.
 
         // Intersects the input lines, then splits them and connects them appropiatly.
+        // In snap rounding mode the lines are first rerouted through the hot pixels, so that they only touch at grid points.
         // Populates the list of edge disjoint lines that only intersect at vertices.
         // puts the edge in consecutive order following the input polylines.
         // results put into this.lines_split
-        void splitIntersectionPoints();
+        // Returns false if the points or lines no longer fit the Index type, see indices_fit.
+        bool splitIntersectionPoints();
+
+        // Returns true iff every point and halfedge may be given an Index and every line position fits in an int.
+        // Otherwise prints an error. Checked while loading, so that too large inputs fail instead of silently wrapping around.
+        bool indices_fit();
 
         // Split version of original input lines, where lines only intersect at vertices.
-        std::vector<scrib::Line> lines_split;
+        scrib::SegmentSoA lines_split;
 
         // Allocates the output graph object and allocates vertices, edges, and halfedges for the input data.
-        // Vertices are Indexed as follows [original points 1 for input polyline 1, then 2, ...,
+        // Vertices are Indexed as follows [distinct original points 1 for input polyline 1, then 2, ...,
         // new intersection points for polyline 1, then 2, etc, ...]
         // Halfedges are indexed in polyline input order, then in backwards input order.
         // -- Step 3. Proccess the embedded input and initialize the Planar Graph vertices, edges, and halfedges.
         void allocate_graph_from_input();
 
+        // The IDs of the halfedges leaving each vertex in compressed sparse row form.
+        // The halfedges leaving the vertex with ID v are outgoing_edges[outgoing_offsets[v]] up to outgoing_edges[outgoing_offsets[v + 1]].
+        // Built with a degree counting pass, a prefix sum and a fill pass, so it takes 2 allocations that are reused between embeddings.
+        std::vector<Index> outgoing_offsets;
+        std::vector<Index> outgoing_edges;
+
+        // Angles of the outgoing edges of the vertex being sorted.
+        std::vector<float> outgoing_angles;
+
         // The graph that is being built.
         // Once it is returned, the responsibility for this memory transfers to the user and the pointer is forgotten from this class.
         // FIXME: Shared_ptr or some other supposedly better pointer type?
@@ -142,9 +237,9 @@ namespace scrib {
         void sort_outgoing_edges_by_angle();
 
         // Step 4 helper function.
-        // Sorts the outgoing_edges by the angles of the lines from the center
+        // Sorts the given number of outgoing edges by the angles of the lines from the center
         //point to the points cooresponding to the outgoing edges.
-        void sort_outgoing_edges(std::vector<Halfedge * > & outgoing_indices);
+        void sort_outgoing_edges(Index * outgoing_indices, int len);
 
         // -- Step 5.
         // Determines the next and previous pointers for the halfedges in the Graph.
@@ -153,6 +248,7 @@ namespace scrib {
         // vertices of degree are on a tail and associate their one pair of neighbors.
         // vertices of degree >2 are intersection points and they first sort their neighbors, then associate their star.
         // This function sets the Vertex_Data objects classification data.
+        // Keeps the outgoing edges in the output graph's Graph_Data if requested, see setKeepOutgoingEdges.
         void associate_halfedge_cycles();
 
 
@@ -181,39 +277,46 @@ namespace scrib {
         // Application Specific allocation functions.
         // REQUIRE: All allocation function need the graph to be already instantiated.
 
+        // The graph passed in by the caller to be reused, or NULL.
+        Graph * recycled_graph = NULL;
+
         Graph * newGraph()
         {
+            if (recycled_graph != NULL)
+            {
+                Graph * output = recycled_graph;
+                recycled_graph = NULL;
+                output -> reset();
+                output -> data -> permutation.clear();
+                output -> data -> stars.clear();
+                output -> data -> chains.clear();
+                return output;
+            }
+
             Graph * output  = new Graph();
             output -> data  = new Graph_Data(output);
             return output;
         }
 
+        // The element data is stored inline, so these only forward to the Graph.
         Face * newFace()
         {
-            Face * output  = graph -> newFace();
-            output -> data = new Face_Data(output);
-            return output;
+            return graph -> newFace();
         };
 
         Edge * newEdge()
         {
-            Edge * output  = graph -> newEdge();
-            output -> data = new Edge_Data(output);
-            return output;
+            return graph -> newEdge();
         }
 
         Halfedge * newHalfedge()
         {
-            Halfedge * output = graph -> newHalfedge();
-            output -> data    = new Halfedge_Data(output);
-            return output;
+            return graph -> newHalfedge();
         }
 
         Vertex * newVertex()
         {
-            Vertex * output = graph -> newVertex();
-            output -> data  = new Vertex_Data(output);
-            return output;
+            return graph -> newVertex();
         }
     };
 }
\ No newline at end of file
@@ -15,6 +15,7 @@
 // General purpose Half edge mesh / graph representation,
 // which may be used to easily implement a variety of sophisticated operations.
 #include "HalfedgeGraph.h"
+#include "GraphSnapshot.h"
 
 // Application specific classes for working with embedded Polyline graphs.
 // Since we control the embedding in house,
@@ -22,4 +23,7 @@
 // to suit our algorithmic and processing needs.
 #include "PolylineGraphEmbedder.h"
 #include "PolylineGraphData.h"
-#include "PolylineGraphPostProcessor.h"
\ No newline at end of file
+#include "PolylineGraphPostProcessor.h"
+#include "SpatialOrder.h"
+#include "GraphFile.h"
+#include "GraphMutator.h"
@@ -64,29 +64,30 @@ namespace scrib
     {
         Face_Vector_Format * output = new Face_Vector_Format();
 
-        Face_Iter start = graph->facesBegin();
-        Face_Iter end = graph->facesEnd();
+        Const_Face_Iter start = view() -> facesBegin();
+        Const_Face_Iter end = view() -> facesEnd();
 
-        for (Face_Iter face = start; face != end; face++)
+        for (Const_Face_Iter face = start; face != end; face++)
         {
             Point_Vector_Format * face_output = new Point_Vector_Format();
 
-            Halfedge * starting_half_edge = (*face) -> halfedge;
-            Halfedge * current = starting_half_edge;
+            Index starting_half_edge = (*face) -> halfedge;
+            Index current = starting_half_edge;
 
             // Convert the entire face into point info objects.
             do
             {
-                Vertex * vert           = current -> vertex;
-                Vertex_Data * vert_data = vert    -> data;
+                const Halfedge * halfedge     = view() -> getHalfedge(current);
+                const Vertex * vert           = view() -> getVertex(halfedge -> vertex);
+                const Vertex_Data & vert_data = vert -> data;
 
-                ofPoint point = vert_data->point;
-                int ID = vert -> ID;
+                ofPoint point = vert_data.point;
+                Index ID = vert -> ID;
 
-                face_output -> push_back(point_info(point, ID, current));
+                face_output -> push_back(point_info(point, ID, halfedge));
 
                 // Iterate.
-                current = current->next;
+                current = halfedge -> next;
             } while (starting_half_edge != current);
 
             output -> push_back(face_output);
@@ -189,8 +190,8 @@ namespace scrib
             return output; // EMPTY.
         }
 
-        int p_start = (input -> at(0)).ID;
-        int p_end   = (input -> at(len - 1)).ID;
+        Index p_start = (input -> at(0)).ID;
+        Index p_end   = (input -> at(len - 1)).ID;
 
         // A polygon is closed if it has identical starting and ending points.
         bool closed = (p_start == p_end);
@@ -226,7 +227,7 @@ namespace scrib
         for (int i = 0; i < len; i++)
         {
             // Determine the nearest previous unpruned point, which will be pruned if it is mirrored by the next point.
-            int p_previous;
+            Index p_previous;
             non_empty_output = output -> size() > 0;
 
             // A non pruned point exists in the output.
@@ -239,7 +240,7 @@ namespace scrib
                 p_previous = (input -> at(len - 1)).ID;
             }
 
-            int p_next = (input -> at((i + 1) % len)).ID;
+            Index p_next = (input -> at((i + 1) % len)).ID;
 
             // If haven't locally detected a tail, then we simply push the point onto the output.
             if (p_previous != p_next)
@@ -285,8 +286,8 @@ namespace scrib
                 return output;
             }
 
-            int p_previous = (output -> at(len - 1)).ID;
-            int p_next = (output -> at(prune_num + 1)).ID;
+            Index p_previous = (output -> at(len - 1)).ID;
+            Index p_next = (output -> at(prune_num + 1)).ID;
 
             if (p_previous != p_next)
             {
@@ -323,15 +324,18 @@ namespace scrib
         std::vector < face_info *> faces_uncomplemented;
         std::vector < face_info *> faces_complemented;
 
+        // Every traced halfedge is marked, so that each union face is traced one time.
+        halfedge_marks.clear(view() -> numHalfedges());
+
         // Go through all halfedges in all relevant faces and trace any representational union faces one time each.
         for (auto iter = face_ID_set -> begin(); iter != face_ID_set -> end(); iter++)
         {
-            Face     * face    = graph -> getFace(*iter);
-            Halfedge * start   = face  -> halfedge;
-            Halfedge * current = face  -> halfedge;
+            const Face     * face    = view() -> getFace(*iter);
+            const Halfedge * start   = view() -> getHalfedge(face -> halfedge);
+            const Halfedge * current = start;
             do
             {
-                if (current -> data -> marked == false && _halfedgeInUnion(face_ID_set, current))
+                if (!halfedge_marks.isMarked(current -> ID) && _halfedgeInUnion(face_ID_set, current))
                 {
                     face_info * face = _traceUnionFace(face_ID_set, current);
                     if (!isComplemented(&(face -> points)))
@@ -347,17 +351,14 @@ namespace scrib
                 }
 
                 // Try the next edge.
-                current = current -> next;
+                current = view() -> getHalfedge(current -> next);
             } while (current != start);
         }
 
-        // Clear markings.
-        graph -> data -> clearHalfedgeMarks();
-
         // Now we associate face_info objects with their internal complemented hole objects.
         std::vector<face_info *> * output = new std::vector<face_info *>();
         
-        std::map<int, face_info *> map;
+        std::map<Index, face_info *> map;
 
         // On the first pass we add all exterior faces to the output and the map.
         for (auto iter = faces_uncomplemented.begin(); iter != faces_uncomplemented.end(); iter++)
@@ -379,8 +380,8 @@ namespace scrib
         for (auto iter = faces_complemented.begin(); iter != faces_complemented.end(); iter++)
         {
             face_info * face = *iter;
-            int ID = *(face -> faces_ID_set.begin());
-            std::map<int, face_info *>::const_iterator it = map.find(ID);
+            Index ID = *(face -> faces_ID_set.begin());
+            std::map<Index, face_info *>::const_iterator it = map.find(ID);
 
             // If the index is not associated with an uncomplemented face, then this uncomplemented face must be singleton,
             // instead of a hole. We therefore add it to the direct output.
@@ -398,14 +399,12 @@ namespace scrib
         return output;
     }
 
-    bool PolylineGraphPostProcessor::_halfedgeInUnion(ID_Set * face_ID_set, Halfedge * start)
+    bool PolylineGraphPostProcessor::_halfedgeInUnion(ID_Set * face_ID_set, const Halfedge * start)
     {
-        Face * face = start -> face;
-        int face_ID = face  -> ID;
+        Index face_ID = start -> face;
         ID_Set::const_iterator face_iter = face_ID_set -> find(face_ID);
 
-        Face * twin_face = start -> twin -> face;
-        int twin_ID = twin_face -> ID;
+        Index twin_ID = view() -> getHalfedge(start -> twin) -> face;
         ID_Set::const_iterator twin_iter = face_ID_set -> find(twin_ID);
 
         // true iff Twin face not in the set of faces in the union.
@@ -416,7 +415,7 @@ namespace scrib
         return face_iter != NOT_FOUND && twin_iter == NOT_FOUND;
     }
 
-    face_info * PolylineGraphPostProcessor::_traceUnionFace(ID_Set * face_ID_set, Halfedge * start)
+    face_info * PolylineGraphPostProcessor::_traceUnionFace(ID_Set * face_ID_set, const Halfedge * start)
     {
         face_info * output = new face_info();
         ID_Set & output_ID_set = output -> faces_ID_set;
@@ -425,15 +424,15 @@ namespace scrib
         // because the holes will associated later on from faces tracede with this function.
         Point_Vector_Format & output_points = output -> points;
 
-        Halfedge * current = start;
+        const Halfedge * current = start;
         do
         {
-            current -> data -> marked = true;
+            halfedge_marks.mark(current -> ID);
 
             // Output current point (with halfedge).
             point_info current_point = halfedgeToPointInfo(current);
             output_points.push_back(current_point);
-            int current_face_ID = current -> face -> ID;
+            Index current_face_ID = current -> face;
             output_ID_set.insert(current_face_ID);
 
             // Transition to the next halfedge along this union face.
@@ -444,12 +443,14 @@ namespace scrib
         return output;
     }
 
-    Halfedge * PolylineGraphPostProcessor::nextUnionFace(ID_Set * face_ID_Set, Halfedge * current)
+    const Halfedge * PolylineGraphPostProcessor::nextUnionFace(ID_Set * face_ID_Set, const Halfedge * current)
     {
         // Go around the star backwards.
 
         // Transition from the incoming current edge to the backmost candidate outgoing edge.
-        current = current -> twin -> prev -> twin;
+        current = view() -> getHalfedge(current -> twin);
+        current = view() -> getHalfedge(current -> prev);
+        current = view() -> getHalfedge(current -> twin);
         
         // NOTE: WE could theoretically put in an infinite loop check here, because this code will fail if the graph is malformed.
 
@@ -457,16 +458,17 @@ namespace scrib
         while(!_halfedgeInUnion(face_ID_Set, current))
         {
             // The cycling operations come in two forms, since we flip our orientation after each path change attempt.
-            current = current -> prev -> twin;   
+            current = view() -> getHalfedge(current -> prev);
+            current = view() -> getHalfedge(current -> twin);
         }
 
         return current;
     }
 
-    point_info PolylineGraphPostProcessor::halfedgeToPointInfo(Halfedge * halfedge)
+    point_info PolylineGraphPostProcessor::halfedgeToPointInfo(const Halfedge * halfedge)
     {
-        Vertex * vertex           = halfedge -> vertex;
-        Vertex_Data * vertex_data = vertex   -> data;
-        return point_info(vertex_data -> point, vertex -> ID, halfedge);
+        const Vertex * vertex           = view() -> getVertex(halfedge -> vertex);
+        const Vertex_Data & vertex_data = vertex -> data;
+        return point_info(vertex_data.point, vertex -> ID, halfedge);
     }
 }
\ No newline at end of file
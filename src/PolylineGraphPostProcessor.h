@@ -16,7 +16,9 @@
 * I may also put information extraction algorithms here.
 *
 * The key idea is that the post processor doesn't mutate the Graph object in any way.
-* FIXME: Use the Graph Mutator Proccessor instead (Currenly non existant.) if you wish to modify the graph.
+* It only reads the Graph through its const getters, which never copy the chunks shared with snapshots,
+* so separate post processors may query the same Graph from separate threads.
+* NOTE: Use the GraphMutator, see GraphMutator.h, if you wish to modify the graph.
 *
 * Maybe I will make a modification mode.
 */
@@ -35,7 +37,7 @@ namespace scrib
     typedef std::vector<ofPoint> OF_Point_Vector_Format;
     typedef std::vector<Point_Vector_Format *> Face_Vector_Format;
     typedef std::vector<int> Int_Vector_Format;
-    typedef std::set<int> ID_Set;
+    typedef std::set<Index> ID_Set;
 
     class point_info
     {
@@ -44,13 +46,13 @@ namespace scrib
         // -- Constructor.
         
         // Used in Facefinder for non halfedgemesh based embeddings.
-        point_info(ofPoint p, int id)
+        point_info(ofPoint p, Index id)
         {
             point = p;
             ID = id;
         }
 
-        point_info(ofPoint p, int id, Halfedge * hedge)
+        point_info(ofPoint p, Index id, const Halfedge * hedge)
         {
             point = p;
             ID = id;
@@ -58,15 +60,16 @@ namespace scrib
         }
 
         ofPoint point;
-        int ID;
+        Index ID;
 
         // The halfedge that this point represents when this point is collected in a Point_Vector to represent a face.
         // This may be used to easily extract local connectivity information and attributes for this point and its neighbors.
         // WARNING: This always points to the original embedding's connectivity information,
         // which means that things like next pointers may no longer be valid after tails are clipped or other algorithms.
         // Faces and twin pointers should still be valid though...
+        // Points into the Graph's halfedge chunks, so it is invalidated if the halfedge is copied on write after a snapshot.
         // Undefined for output from scrib::FaceFinder.
-        Halfedge * halfedge = NULL;
+        const Halfedge * halfedge = NULL;
     };
 
     class face_info
@@ -116,6 +119,10 @@ namespace scrib
         // Face point vector format. // FIXME: Consider using smart pointers.
         Face_Vector_Format * face_vector = NULL;
 
+        // Marks the halfedges visited by a query. Owned by this post processor rather than the graph,
+        // so separate post processors may run queries on the same graph from separate threads.
+        Mark_Set halfedge_marks;
+
     public:
 
         // -- Data Structure Conversion.
@@ -144,6 +151,12 @@ namespace scrib
             this -> graph = graph;
         }
 
+        Graph * getGraph()
+        {
+            return this -> graph;
+        }
+
+        // Deletes the loaded graph, which frees all of its elements and data.
         void freeGraph()
         {
             if(this -> graph != NULL)
@@ -186,17 +199,23 @@ namespace scrib
         // Returns true iff the given hafedge is included in the output of the union of the given faces.
         // I.E. returns true iff the given half edge -> face is within the set of unioned faces and half_edge->twin -> face is not.
         // Tail edges, where the halfedge and its twin are on the same face are not considered to be in a halfedgeUnion face.
-        bool _halfedgeInUnion(ID_Set * face_ID_set, Halfedge * start);
+        bool _halfedgeInUnion(ID_Set * face_ID_set, const Halfedge * start);
 
         // Given an In Union halfege, traces its face_info union face information.
         // Properly sets the output's: points and face_IDs fields.
-        // Marks halfedges, therefore calling functions are responsible for unmarking halfedges.
-        face_info * _traceUnionFace(ID_Set * face_ID_set, Halfedge * start);
+        // Marks the traced halfedges in this -> halfedge_marks.
+        face_info * _traceUnionFace(ID_Set * face_ID_set, const Halfedge * start);
 
         // Given a halfedge inside of a unionface, returns the next halfedge within that face.
-        Halfedge * nextUnionFace(ID_Set * face_ID_Set, Halfedge * current);
+        const Halfedge * nextUnionFace(ID_Set * face_ID_Set, const Halfedge * current);
 
-        point_info halfedgeToPointInfo(Halfedge * halfedge);
+        point_info halfedgeToPointInfo(const Halfedge * halfedge);
+
+        // Read only access to the loaded graph, see the const getters of Graph_T.
+        const Graph * view() const
+        {
+            return graph;
+        }
 
     };
 }
\ No newline at end of file
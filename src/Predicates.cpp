@@ -0,0 +1,88 @@
+/*
+*  Predicates.cpp
+*
+*  Written on 10/17/2026.
+*
+*/
+
+#include "Predicates.h"
+
+namespace scrib
+{
+
+    // Computes x + y = a + b exactly, where x is the rounded sum and y is the round off error.
+    static inline void two_sum(double a, double b, double & x, double & y)
+    {
+        x = a + b;
+        double bvirt  = x - a;
+        double avirt  = x - bvirt;
+        double bround = b - bvirt;
+        double around = a - avirt;
+        y = around + bround;
+    }
+
+    // Adds b to the nonoverlapping expansion e of length len in place, dropping zero components.
+    // Expansion components are ordered by increasing magnitude. Returns the new length.
+    static int grow_expansion(double * e, int len, double b)
+    {
+        double q = b;
+        int out = 0;
+
+        for (int i = 0; i < len; i++)
+        {
+            double hh;
+            two_sum(q, e[i], q, hh);
+
+            if (hh != 0.0)
+            {
+                e[out++] = hh;
+            }
+        }
+
+        if (q != 0.0 || out == 0)
+        {
+            e[out++] = q;
+        }
+
+        return out;
+    }
+
+    int orientation_exact(float ax, float ay, float bx, float by, float cx, float cy)
+    {
+        // (bx - ax)(cy - ay) - (by - ay)(cx - ax), multiplied out.
+        // The ax*ay terms cancel and every remaining product of two floats is exact in double precision.
+        double terms[6] =
+        {
+             (double)bx * cy,
+            -(double)bx * ay,
+            -(double)ax * cy,
+            -(double)by * cx,
+             (double)by * ax,
+             (double)ay * cx
+        };
+
+        double expansion[7];
+        int len = 0;
+
+        for (int i = 0; i < 6; i++)
+        {
+            len = grow_expansion(expansion, len, terms[i]);
+        }
+
+        // The largest component determines the sign.
+        double most_significant = expansion[len - 1];
+
+        if (most_significant > 0)
+        {
+            return 1;
+        }
+
+        if (most_significant < 0)
+        {
+            return -1;
+        }
+
+        return 0;
+    }
+
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+/*
+* Robust Geometric Predicates.
+*
+* Written on 10/17/2026.
+*
+* Purpose: Replaces the random perturbation of the input points with predicates that always give the correct answer.
+*
+* The orientation test is first evaluated in double precision, which is enough to decide almost every query.
+* Only when the result lies within the rounding error bound is the test reevaluated exactly using floating point expansions.
+* (See Shewchuk, "Adaptive Precision Floating-Point Arithmetic and Fast Robust Geometric Predicates".)
+* Products of two floats are exactly representable as doubles, so the exact path is exact for all float inputs.
+*
+* NOTE: The exact path relies on strict IEEE double arithmetic, so do not compile this with fast math options.
+*/
+
+#include <math.h>
+
+namespace scrib
+{
+
+    // Exact fallback, only called by orientation when the fast path can not decide.
+    int orientation_exact(float ax, float ay, float bx, float by, float cx, float cy);
+
+    // Returns 1 if c is to the left of the directed line a --> b (counter clockwise in y up coordinates),
+    // -1 if it is to the right and 0 iff the three points are exactly collinear.
+    inline int orientation(float ax, float ay, float bx, float by, float cx, float cy)
+    {
+        // Error bound for the double precision evaluation. (3 + 16 eps) eps, where eps = 2^-53.
+        const double ERROR_BOUND = 3.3306690738754716e-16;
+
+        double detleft  = ((double)bx - ax) * ((double)cy - ay);
+        double detright = ((double)by - ay) * ((double)cx - ax);
+        double det      = detleft - detright;
+        double bound    = ERROR_BOUND * (fabs(detleft) + fabs(detright));
+
+        if (det > bound)
+        {
+            return 1;
+        }
+
+        if (-det > bound)
+        {
+            return -1;
+        }
+
+        return orientation_exact(ax, ay, bx, by, cx, cy);
+    }
+
+}
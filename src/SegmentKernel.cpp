@@ -0,0 +1,255 @@
+/*
+*  SegmentKernel.cpp
+*
+*  Written on 10/17/2026.
+*
+*/
+
+#include "SegmentKernel.h"
+#include <math.h>
+
+#ifdef SCRIB_SIMD_SSE2
+#include <emmintrin.h>
+#endif
+
+#ifdef SCRIB_SIMD_AVX2
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define SCRIB_TARGET_AVX2
+#else
+#define SCRIB_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace scrib
+{
+
+    static inline void append_hits(int mask, int position, std::vector<int> & hits)
+    {
+        for (int bit = 0; mask != 0; bit++, mask >>= 1)
+        {
+            if (mask & 1)
+            {
+                hits.push_back(position + bit);
+            }
+        }
+    }
+
+    static void find_crossings_scalar(SegmentSoA & s, int a, int start, int end, std::vector<int> & hits)
+    {
+        for (int b = start; b < end; b++)
+        {
+            if (s.crosses(a, b))
+            {
+                hits.push_back(b);
+            }
+        }
+    }
+
+#ifdef SCRIB_SIMD_SSE2
+
+    // The SIMD paths evaluate the line side tests in single precision, so they are only used as a conservative filter.
+    // A candidate is rejected only if both of its end points are on the same side of the line by more than the rounding error,
+    // which is below (3 + 16 eps) eps (|dx| |y - y1| + |dy| |x - x1|) for eps = 2^-24.
+    // The longest extents of any segment bound |dx| and |dy| and the bounding box of all of the segments bounds |y - y1| and |x - x1|,
+    // so a single bound covers every side test. Every hit is confirmed exactly by SegmentSoA::intersect.
+    static inline float side_error_bound(SegmentSoA & s)
+    {
+        const float SIDE_ERROR_BOUND = 4.76837158e-7f; // 2^-21, rounded up generously.
+        return SIDE_ERROR_BOUND * (s.max_dx * (s.max_y - s.min_y) + s.max_dy * (s.max_x - s.min_x));
+    }
+
+    // 4 candidates at a time.
+    static inline __m128 same_side_sse2(__m128 side1, __m128 side2, __m128 bound, __m128 negative_bound)
+    {
+        return _mm_or_ps(_mm_cmpgt_ps(_mm_min_ps(side1, side2), bound),
+                         _mm_cmplt_ps(_mm_max_ps(side1, side2), negative_bound));
+    }
+
+    // True in the lanes where either end point is off the line by more than the rounding error, so the lines are not collinear.
+    static inline __m128 off_line_sse2(__m128 side1, __m128 side2, __m128 bound, __m128 negative_bound)
+    {
+        return _mm_or_ps(_mm_cmpgt_ps(_mm_max_ps(side1, side2), bound),
+                         _mm_cmplt_ps(_mm_min_ps(side1, side2), negative_bound));
+    }
+
+    static void find_crossings_sse2(SegmentSoA & s, int a, int start, int end, std::vector<int> & hits)
+    {
+        float error_bound = side_error_bound(s);
+        __m128 bound = _mm_set1_ps(error_bound);
+        __m128 negative_bound = _mm_set1_ps(-error_bound);
+
+        __m128 ax1 = _mm_set1_ps(s.x1[a]);
+        __m128 ay1 = _mm_set1_ps(s.y1[a]);
+        __m128 ax2 = _mm_set1_ps(s.x2[a]);
+        __m128 ay2 = _mm_set1_ps(s.y2[a]);
+        __m128 adx = _mm_sub_ps(ax2, ax1);
+        __m128 ady = _mm_sub_ps(ay2, ay1);
+#ifndef SCRIB_64_BIT_INDICES
+        __m128i ai1 = _mm_set1_epi32(s.i1[a]);
+        __m128i ai2 = _mm_set1_epi32(s.i2[a]);
+#endif
+
+        int b = start;
+        for (; b + 4 <= end; b += 4)
+        {
+            __m128 bx1 = _mm_loadu_ps(&s.x1[b]);
+            __m128 by1 = _mm_loadu_ps(&s.y1[b]);
+            __m128 bx2 = _mm_loadu_ps(&s.x2[b]);
+            __m128 by2 = _mm_loadu_ps(&s.y2[b]);
+            __m128 bdx = _mm_sub_ps(bx2, bx1);
+            __m128 bdy = _mm_sub_ps(by2, by1);
+
+            __m128 a1 = _mm_sub_ps(_mm_mul_ps(adx, _mm_sub_ps(by1, ay1)), _mm_mul_ps(ady, _mm_sub_ps(bx1, ax1)));
+            __m128 a2 = _mm_sub_ps(_mm_mul_ps(adx, _mm_sub_ps(by2, ay1)), _mm_mul_ps(ady, _mm_sub_ps(bx2, ax1)));
+            __m128 b1 = _mm_sub_ps(_mm_mul_ps(bdx, _mm_sub_ps(ay1, by1)), _mm_mul_ps(bdy, _mm_sub_ps(ax1, bx1)));
+            __m128 b2 = _mm_sub_ps(_mm_mul_ps(bdx, _mm_sub_ps(ay2, by1)), _mm_mul_ps(bdy, _mm_sub_ps(ax2, bx1)));
+
+            __m128 separated = _mm_or_ps(same_side_sse2(a1, a2, bound, negative_bound),
+                                         same_side_sse2(b1, b2, bound, negative_bound));
+
+#ifndef SCRIB_64_BIT_INDICES
+            __m128i bi1 = _mm_loadu_si128((const __m128i *)&s.i1[b]);
+            __m128i bi2 = _mm_loadu_si128((const __m128i *)&s.i2[b]);
+            __m128i shared = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi32(ai1, bi1), _mm_cmpeq_epi32(ai1, bi2)),
+                                          _mm_or_si128(_mm_cmpeq_epi32(ai2, bi1), _mm_cmpeq_epi32(ai2, bi2)));
+
+            // Connected candidates only meet beyond their joint if they fold back along the line, see SegmentSoA::intersect,
+            // so they are kept unless they are clearly not collinear with it.
+            __m128 joined = _mm_and_ps(_mm_castsi128_ps(shared), off_line_sse2(a1, a2, bound, negative_bound));
+            __m128 rejected = _mm_or_ps(separated, joined);
+#else
+            // 64 bit indices do not fit the lanes, connected candidates are left to SegmentSoA::intersect.
+            __m128 rejected = separated;
+#endif
+            append_hits(~_mm_movemask_ps(rejected) & 0xf, b, hits);
+        }
+
+        find_crossings_scalar(s, a, b, end, hits);
+    }
+
+#endif
+
+#ifdef SCRIB_SIMD_AVX2
+
+    // 8 candidates at a time.
+    SCRIB_TARGET_AVX2
+    static inline __m256 same_side_avx2(__m256 side1, __m256 side2, __m256 bound, __m256 negative_bound)
+    {
+        return _mm256_or_ps(_mm256_cmp_ps(_mm256_min_ps(side1, side2), bound, _CMP_GT_OQ),
+                            _mm256_cmp_ps(_mm256_max_ps(side1, side2), negative_bound, _CMP_LT_OQ));
+    }
+
+    SCRIB_TARGET_AVX2
+    static inline __m256 off_line_avx2(__m256 side1, __m256 side2, __m256 bound, __m256 negative_bound)
+    {
+        return _mm256_or_ps(_mm256_cmp_ps(_mm256_max_ps(side1, side2), bound, _CMP_GT_OQ),
+                            _mm256_cmp_ps(_mm256_min_ps(side1, side2), negative_bound, _CMP_LT_OQ));
+    }
+
+    SCRIB_TARGET_AVX2
+    static void find_crossings_avx2(SegmentSoA & s, int a, int start, int end, std::vector<int> & hits)
+    {
+        float error_bound = side_error_bound(s);
+        __m256 bound = _mm256_set1_ps(error_bound);
+        __m256 negative_bound = _mm256_set1_ps(-error_bound);
+
+        __m256 ax1 = _mm256_set1_ps(s.x1[a]);
+        __m256 ay1 = _mm256_set1_ps(s.y1[a]);
+        __m256 ax2 = _mm256_set1_ps(s.x2[a]);
+        __m256 ay2 = _mm256_set1_ps(s.y2[a]);
+        __m256 adx = _mm256_sub_ps(ax2, ax1);
+        __m256 ady = _mm256_sub_ps(ay2, ay1);
+#ifndef SCRIB_64_BIT_INDICES
+        __m256i ai1 = _mm256_set1_epi32(s.i1[a]);
+        __m256i ai2 = _mm256_set1_epi32(s.i2[a]);
+#endif
+
+        int b = start;
+        for (; b + 8 <= end; b += 8)
+        {
+            __m256 bx1 = _mm256_loadu_ps(&s.x1[b]);
+            __m256 by1 = _mm256_loadu_ps(&s.y1[b]);
+            __m256 bx2 = _mm256_loadu_ps(&s.x2[b]);
+            __m256 by2 = _mm256_loadu_ps(&s.y2[b]);
+            __m256 bdx = _mm256_sub_ps(bx2, bx1);
+            __m256 bdy = _mm256_sub_ps(by2, by1);
+
+            __m256 a1 = _mm256_sub_ps(_mm256_mul_ps(adx, _mm256_sub_ps(by1, ay1)), _mm256_mul_ps(ady, _mm256_sub_ps(bx1, ax1)));
+            __m256 a2 = _mm256_sub_ps(_mm256_mul_ps(adx, _mm256_sub_ps(by2, ay1)), _mm256_mul_ps(ady, _mm256_sub_ps(bx2, ax1)));
+            __m256 b1 = _mm256_sub_ps(_mm256_mul_ps(bdx, _mm256_sub_ps(ay1, by1)), _mm256_mul_ps(bdy, _mm256_sub_ps(ax1, bx1)));
+            __m256 b2 = _mm256_sub_ps(_mm256_mul_ps(bdx, _mm256_sub_ps(ay2, by1)), _mm256_mul_ps(bdy, _mm256_sub_ps(ax2, bx1)));
+
+            __m256 separated = _mm256_or_ps(same_side_avx2(a1, a2, bound, negative_bound),
+                                            same_side_avx2(b1, b2, bound, negative_bound));
+
+#ifndef SCRIB_64_BIT_INDICES
+            __m256i bi1 = _mm256_loadu_si256((const __m256i *)&s.i1[b]);
+            __m256i bi2 = _mm256_loadu_si256((const __m256i *)&s.i2[b]);
+            __m256i shared = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi32(ai1, bi1), _mm256_cmpeq_epi32(ai1, bi2)),
+                                             _mm256_or_si256(_mm256_cmpeq_epi32(ai2, bi1), _mm256_cmpeq_epi32(ai2, bi2)));
+
+            __m256 joined = _mm256_and_ps(_mm256_castsi256_ps(shared), off_line_avx2(a1, a2, bound, negative_bound));
+            __m256 rejected = _mm256_or_ps(separated, joined);
+#else
+            __m256 rejected = separated;
+#endif
+            append_hits(~_mm256_movemask_ps(rejected) & 0xff, b, hits);
+        }
+
+        find_crossings_sse2(s, a, b, end, hits);
+    }
+
+    static bool cpu_supports_avx2()
+    {
+#ifdef _MSC_VER
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7)
+        {
+            return false;
+        }
+
+        // The operating system must also save the ymm registers.
+        __cpuid(info, 1);
+        if ((info[2] & (1 << 27)) == 0 || (_xgetbv(0) & 6) != 6)
+        {
+            return false;
+        }
+
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+#else
+        return __builtin_cpu_supports("avx2");
+#endif
+    }
+
+#endif
+
+    typedef void (*Crossing_Kernel)(SegmentSoA &, int, int, int, std::vector<int> &);
+
+    static Crossing_Kernel select_kernel()
+    {
+#ifdef SCRIB_SIMD_AVX2
+        if (cpu_supports_avx2())
+        {
+            return find_crossings_avx2;
+        }
+#endif
+
+#ifdef SCRIB_SIMD_SSE2
+        return find_crossings_sse2;
+#else
+        return find_crossings_scalar;
+#endif
+    }
+
+    void findCrossings(SegmentSoA & segments, int a, int start, int end, std::vector<int> & hits)
+    {
+        // Chosen once, the first time the kernel is used.
+        static Crossing_Kernel kernel = select_kernel();
+        kernel(segments, a, start, end, hits);
+    }
+
+}
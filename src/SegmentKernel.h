@@ -0,0 +1,37 @@
+#pragma once
+
+/*
+* Batched Segment Intersection Kernel.
+*
+* Written on 10/17/2026.
+*
+* Purpose: Tests one line segment against many candidate segments at a time using SIMD instructions.
+*
+* The segments are stored in a compact structure of arrays, see Segments.h, so that 4 (SSE2) or 8 (AVX2) candidates
+* may be loaded at once. The AVX2 path is selected at runtime if the processor supports it,
+* and a scalar path is used on processors without SSE2, such as the ARM boards openframeworks runs on.
+*
+* The SIMD paths only reject candidates that are separated by more than the single precision rounding error,
+* so they may be used as a conservative filter in front of SegmentSoA::intersect, which confirms every hit exactly.
+*/
+
+#include <vector>
+#include "Segments.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SCRIB_SIMD_SSE2
+#endif
+
+#if defined(SCRIB_SIMD_SSE2) && (defined(_MSC_VER) || defined(__GNUC__))
+#define SCRIB_SIMD_AVX2
+#endif
+
+namespace scrib
+{
+
+    // Tests the segment at position a against the candidates at positions [start, end)
+    // and appends the positions of the candidates that may cross it to hits.
+    // Never misses a crossing, but may report candidates that SegmentSoA::crosses rejects.
+    void findCrossings(SegmentSoA & segments, int a, int start, int end, std::vector<int> & hits);
+
+}
@@ -0,0 +1,609 @@
+#include "Segments.h"
+#include "Predicates.h"
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+#include <limits>
+#include <algorithm>
+
+namespace scrib {
+
+    // ============================================================
+    // Structure of Arrays.
+    // -----------------------------
+
+    SegmentSoA::SegmentSoA()
+    {
+        points = NULL;
+        splits = NULL;
+        clear();
+    }
+
+    SegmentSoA::SegmentSoA(std::vector<ofPoint> * points_global)
+    {
+        // The indices point to points within this global array.
+        points = points_global;
+        splits = NULL;
+        clear();
+    }
+
+    void SegmentSoA::clear()
+    {
+        x1.clear();
+        y1.clear();
+        x2.clear();
+        y2.clear();
+        i1.clear();
+        i2.clear();
+
+        min_x = min_y =  std::numeric_limits<float>::max();
+        max_x = max_y = -std::numeric_limits<float>::max();
+        max_dx = max_dy = 0;
+    }
+
+    void SegmentSoA::reserve(size_t size)
+    {
+        x1.reserve(size);
+        y1.reserve(size);
+        x2.reserve(size);
+        y2.reserve(size);
+        i1.reserve(size);
+        i2.reserve(size);
+    }
+
+    void SegmentSoA::push_back(Index start_point, Index end_point)
+    {
+        ofPoint & p1 = points->at(start_point);
+        ofPoint & p2 = points->at(end_point);
+        push_back(p1.x, p1.y, p2.x, p2.y, start_point, end_point);
+    }
+
+    void SegmentSoA::push_back(SegmentSoA & other, int position)
+    {
+        push_back(other.x1[position], other.y1[position], other.x2[position], other.y2[position],
+                  other.i1[position], other.i2[position]);
+    }
+
+    void SegmentSoA::push_back(float px1, float py1, float px2, float py2, Index start_point, Index end_point)
+    {
+        x1.push_back(px1);
+        y1.push_back(py1);
+        x2.push_back(px2);
+        y2.push_back(py2);
+        i1.push_back(start_point);
+        i2.push_back(end_point);
+
+        min_x = min(min_x, min(px1, px2));
+        max_x = max(max_x, max(px1, px2));
+        min_y = min(min_y, min(py1, py2));
+        max_y = max(max_y, max(py1, py2));
+        max_dx = max(max_dx, (float)fabs(px2 - px1));
+        max_dy = max(max_dy, (float)fabs(py2 - py1));
+    }
+
+    void SegmentSoA::move(int from, int to)
+    {
+        x1[to] = x1[from];
+        y1[to] = y1[from];
+        x2[to] = x2[from];
+        y2[to] = y2[from];
+        i1[to] = i1[from];
+        i2[to] = i2[from];
+    }
+
+    void SegmentSoA::resize(size_t size)
+    {
+        x1.resize(size);
+        y1.resize(size);
+        x2.resize(size);
+        y2.resize(size);
+        i1.resize(size);
+        i2.resize(size);
+    }
+
+    void SegmentSoA::swap(SegmentSoA & other)
+    {
+        x1.swap(other.x1);
+        y1.swap(other.y1);
+        x2.swap(other.x2);
+        y2.swap(other.y2);
+        i1.swap(other.i1);
+        i2.swap(other.i2);
+
+        std::swap(points, other.points);
+        std::swap(splits, other.splits);
+        std::swap(min_x,  other.min_x);
+        std::swap(max_x,  other.max_x);
+        std::swap(min_y,  other.min_y);
+        std::swap(max_y,  other.max_y);
+        std::swap(max_dx, other.max_dx);
+        std::swap(max_dy, other.max_dy);
+    }
+
+    // Returns -1 on one side of the line.
+    // Returns 0 if the point is on the line.
+    // Returns 1 if the point is on the other side of the line.
+    int SegmentSoA::side(int position, float x, float y)
+    {
+        return orientation(x1[position], y1[position], x2[position], y2[position], x, y);
+    }
+
+    // Fills sides with the line side tests of b's end points against a and then the reverse.
+    // Returns true iff the lines intersect.
+    static inline bool detect_intersection(SegmentSoA & lines_a, int a, SegmentSoA & lines_b, int b, int * sides)
+    {
+        int a1 = sides[0] = lines_a.side(a, lines_b.x1[b], lines_b.y1[b]);
+        int a2 = sides[1] = lines_a.side(a, lines_b.x2[b], lines_b.y2[b]);
+
+        if (a1*a2 > 0)
+        {
+            return false;
+        }
+
+        int b1 = sides[2] = lines_b.side(b, lines_a.x1[a], lines_a.y1[a]);
+        int b2 = sides[3] = lines_b.side(b, lines_a.x2[a], lines_a.y2[a]);
+
+        /* The product of two point based line side tests will be negative iff
+        * the points are not on strictly opposite sides of the line.
+        * If the product is 0, then at least one of the points is on the line not containing the points.
+        */
+        return a1*a2 <= 0 && b1*b2 <= 0;
+    }
+
+    // Already Previously Connected.
+    // Connected at a joint in the input polyline.
+    static inline bool share_end_point(SegmentSoA & lines_a, int a, SegmentSoA & lines_b, int b)
+    {
+        return lines_a.i1[a] == lines_b.i1[b] || lines_a.i1[a] == lines_b.i2[b] ||
+               lines_a.i2[a] == lines_b.i1[b] || lines_a.i2[a] == lines_b.i2[b];
+    }
+
+    // Lines sharing an end point only meet elsewhere if they fold back along each other, e.g. (0, 0) -> (10, 0) -> (5, 0).
+    // Then they are collinear and an end point of one line lies strictly between the end points of the other line.
+    static inline bool folds_back(SegmentSoA & lines_a, int a, SegmentSoA & lines_b, int b)
+    {
+        if (lines_a.side(a, lines_b.x1[b], lines_b.y1[b]) != 0 || lines_a.side(a, lines_b.x2[b], lines_b.y2[b]) != 0)
+        {
+            return false;
+        }
+
+        return lines_a.between(a, lines_b.x1[b], lines_b.y1[b]) || lines_a.between(a, lines_b.x2[b], lines_b.y2[b]) ||
+               lines_b.between(b, lines_a.x1[a], lines_a.y1[a]) || lines_b.between(b, lines_a.x2[a], lines_a.y2[a]);
+    }
+
+    bool SegmentSoA::crosses(int a, int b)
+    {
+        if (share_end_point(*this, a, *this, b))
+        {
+            return folds_back(*this, a, *this, b);
+        }
+
+        int sides[4];
+        return detect_intersection(*this, a, *this, b, sides);
+    }
+
+    // Returns true iff the lines intersect, if they are not already connected at endpoints a split point is created.
+    // Intersections at shared end points --> a false return, unless the lines fold back along each other.
+    // An end point touching the interior of the other line splits the other line at that existing point.
+    bool SegmentSoA::intersect(SegmentSoA & lines_a, int a, SegmentSoA & lines_b, int b)
+    {
+        int sides[4];
+
+        if (share_end_point(lines_a, a, lines_b, b))
+        {
+            if (!folds_back(lines_a, a, lines_b, b))
+            {
+                return false;
+            }
+
+            // The far end point of the shorter line splits the longer line. The shared end point never splits either line.
+            sides[0] = sides[1] = sides[2] = sides[3] = 0;
+        }
+        else if (!detect_intersection(lines_a, a, lines_b, b, sides))
+        {
+            return false;
+        }
+
+        int a1 = sides[0];
+        int a2 = sides[1];
+        int b1 = sides[2];
+        int b2 = sides[3];
+
+        // The lines properly cross, so a new point is created.
+        if (a1 != 0 && a2 != 0 && b1 != 0 && b2 != 0)
+        {
+            report_crossing(lines_a, a, lines_b, b);
+            return true;
+        }
+
+        // An end point lies on the interior of the other line.
+        // The line is split at the existing point and no new point is created.
+        // Collinear lines have every side test 0, so every end point strictly inside of the other line splits it.
+        // The overlapping portions become duplicate lines, which are removed after splitting.
+
+        if (a1 == 0)
+        {
+            lines_a.report_touch(a, lines_b.x1[b], lines_b.y1[b], lines_b.i1[b], b);
+        }
+
+        if (a2 == 0)
+        {
+            lines_a.report_touch(a, lines_b.x2[b], lines_b.y2[b], lines_b.i2[b], b);
+        }
+
+        if (b1 == 0)
+        {
+            lines_b.report_touch(b, lines_a.x1[a], lines_a.y1[a], lines_a.i1[a], a);
+        }
+
+        if (b2 == 0)
+        {
+            lines_b.report_touch(b, lines_a.x2[a], lines_a.y2[a], lines_a.i2[a], a);
+        }
+
+        return true;
+    }
+
+    void SegmentSoA::report_crossing(SegmentSoA & lines_a, int a, SegmentSoA & lines_b, int b)
+    {
+
+        // Find the intersection point.
+
+        /*
+        u = ((bs.y - as.y) * bd.x - (bs.x - as.x) * bd.y) / (bd.x * ad.y - bd.y * ad.x)
+        v = ((bs.y - as.y) * ad.x - (bs.x - as.x) * ad.y) / (bd.x * ad.y - bd.y * ad.x)
+        Factoring out the common terms, this comes to:
+
+        dx = bs.x - as.x
+        dy = bs.y - as.y
+        det = bd.x * ad.y - bd.y * ad.x
+        u = (dy * bd.x - dx * bd.y) / det
+        v = (dy * ad.x - dx * ad.y) / det
+        */
+
+        // Evaluated in double precision, where the differences and products of float coordinates are almost always exact.
+        // Lines crossing at the same point then compute bitwise identical points, which are merged by mergeCoincidentPoints.
+        double ax  = lines_a.x1[a];
+        double ay  = lines_a.y1[a];
+        double adx = (double)lines_a.x2[a] - ax;
+        double ady = (double)lines_a.y2[a] - ay;
+        double bdx = (double)lines_b.x2[b] - lines_b.x1[b];
+        double bdy = (double)lines_b.y2[b] - lines_b.y1[b];
+
+        double dx = (double)lines_b.x1[b] - ax;
+        double dy = (double)lines_b.y1[b] - ay;
+        double det = bdx * ady - bdy * adx;
+        double u = (dy * bdx - dx * bdy) / det;
+        double v = (dy * adx - dx * ady) / det;
+
+        // The intersection is at time coordinates u and v.
+        // Note: Time is relative to the offsets, so the first end point is time 0 and the second is time 1.
+
+        ofPoint intersection_point(ax + adx*u, ay + ady*u);
+
+        // Get the next index that will be used to store the newly created point.
+        std::vector<ofPoint> * points = lines_a.points;
+        Index point_index = points->size();
+        points->push_back(intersection_point);
+
+        // u is the time coordinate for line a.
+        lines_a.splits->add(a, b, (float)u, point_index);
+
+        // v is the time coordinate for line b.
+        lines_b.splits->add(b, a, (float)v, point_index);
+    }
+
+    bool SegmentSoA::between(int position, float x, float y)
+    {
+        float px1 = x1[position];
+        float py1 = y1[position];
+        float px2 = x2[position];
+        float py2 = y2[position];
+
+        // Compare along the axis that the line is not constant in, this is exact.
+        if (px1 != px2)
+        {
+            return (px1 < x && x < px2) || (px2 < x && x < px1);
+        }
+
+        return (py1 < y && y < py2) || (py2 < y && y < py1);
+    }
+
+    // The given point is known to be on this line's supporting line.
+    void SegmentSoA::report_touch(int position, float x, float y, Index point_index, int other)
+    {
+        // Only points strictly between the end points split this line.
+        if (!between(position, x, y))
+        {
+            return;
+        }
+
+        float px1 = x1[position];
+        float py1 = y1[position];
+
+        // The time coordinate is only used to order the split points.
+        float offset_x = x2[position] - px1;
+        float offset_y = y2[position] - py1;
+        float per = ((x - px1)*offset_x + (y - py1)*offset_y) / (offset_x*offset_x + offset_y*offset_y);
+
+        splits->add(position, other, per, point_index);
+    }
+
+    /*
+    bool isLeft(Point a, Point b, Point c){
+    return ((b.x - a.x)*(c.y - a.y) - (b.y - a.y)*(c.x - a.x)) > 0;
+    }
+    */
+
+
+    void SplitBuffer::attach(SegmentSoA * lines)
+    {
+        records.clear();
+        lines->splits = this;
+    }
+
+    // Orders by line, then by time coordinate.
+    // The bits of a float compare like unsigned integers once negative values are flipped and positive values get their sign bit set.
+    static inline uint64_t split_key(const Split_Record & record)
+    {
+        uint32_t bits;
+        memcpy(&bits, &record.per, sizeof(bits));
+        bits = (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+
+        return ((uint64_t)(uint32_t)record.line << 32) | bits;
+    }
+
+    void SplitBuffer::sort()
+    {
+        int len = records.size();
+
+        if (len < 2)
+        {
+            return;
+        }
+
+        // Least significant digit first radix sort on 8 bit digits, which is stable.
+        // The histograms for every digit are counted in one pass, and digits that are the same for every record are skipped.
+        const int DIGITS = 8;
+        std::vector<int> counts(DIGITS * 256, 0);
+        std::vector<uint64_t> keys(len);
+
+        for (int i = 0; i < len; i++)
+        {
+            keys[i] = split_key(records[i]);
+
+            for (int d = 0; d < DIGITS; d++)
+            {
+                counts[d * 256 + ((keys[i] >> (d * 8)) & 0xff)]++;
+            }
+        }
+
+        std::vector<uint64_t> keys_sorted(len);
+        std::vector<Split_Record> records_sorted(len);
+
+        for (int d = 0; d < DIGITS; d++)
+        {
+            int * count = &counts[d * 256];
+            int shift = d * 8;
+
+            if (count[(keys[0] >> shift) & 0xff] == len)
+            {
+                continue;
+            }
+
+            // Counts --> starting offsets.
+            int offset = 0;
+            for (int digit = 0; digit < 256; digit++)
+            {
+                int size = count[digit];
+                count[digit] = offset;
+                offset += size;
+            }
+
+            for (int i = 0; i < len; i++)
+            {
+                int position = count[(keys[i] >> shift) & 0xff]++;
+                keys_sorted[position]    = keys[i];
+                records_sorted[position] = records[i];
+            }
+
+            keys.swap(keys_sorted);
+            records.swap(records_sorted);
+        }
+    }
+
+    // Appends all of the lines that are used to subdivide the lines,
+    // complete with proper and consistent indices into the global array.
+    void SplitBuffer::getSplitLines(SegmentSoA & lines, SegmentSoA * output)
+    {
+        sort();
+
+        output->points = lines.points;
+
+        int numRecords = records.size();
+        int r = 0;
+
+        int len = lines.size();
+        for (int i = 0; i < len; i++)
+        {
+            // No split points.
+            if (r == numRecords || records[r].line != i)
+            {
+                output->push_back(lines, i);
+                continue;
+            }
+
+            Index last_index = lines.i1[i];
+
+            for (; r < numRecords && records[r].line == i; r++)
+            {
+                Index next_index = records[r].point;
+
+                // A joint of a polyline touching this line is reported once by each of the lines meeting there.
+                if (next_index == last_index)
+                {
+                    continue;
+                }
+
+                output->push_back(last_index, next_index);
+                last_index = next_index;
+            }
+
+            // The last line.
+            output->push_back(last_index, lines.i2[i]);
+        }
+    }
+
+    void mergeCoincidentPoints(std::vector<ofPoint> * points, SegmentSoA * lines)
+    {
+        Index numPoints = points->size();
+
+        // Sort the points by their coordinates, ties are broken by index so that the first copy of each point is kept.
+        struct Sorted_Point
+        {
+            float x;
+            float y;
+            Index index;
+
+            bool operator<(const Sorted_Point & other) const
+            {
+                if (x != other.x)
+                {
+                    return x < other.x;
+                }
+
+                if (y != other.y)
+                {
+                    return y < other.y;
+                }
+
+                return index < other.index;
+            }
+        };
+
+        std::vector<Sorted_Point> sorted(numPoints);
+        for (Index i = 0; i < numPoints; i++)
+        {
+            sorted[i].x = points->at(i).x;
+            sorted[i].y = points->at(i).y;
+            sorted[i].index = i;
+        }
+
+        std::sort(sorted.begin(), sorted.end());
+
+        std::vector<Index> canonical(numPoints);
+        bool merged = false;
+        for (Index i = 0; i < numPoints; i++)
+        {
+            Index index = sorted[i].index;
+            canonical[index] = index;
+
+            if (i > 0 && sorted[i].x == sorted[i - 1].x && sorted[i].y == sorted[i - 1].y)
+            {
+                canonical[index] = canonical[sorted[i - 1].index];
+                merged = true;
+            }
+        }
+
+        if (!merged)
+        {
+            removeDuplicateLines(lines);
+            return;
+        }
+
+        // Compact the remaining points, keeping their order.
+        std::vector<Index> compact(numPoints, NULL_ID);
+        Index out = 0;
+        for (Index i = 0; i < numPoints; i++)
+        {
+            if (canonical[i] == i)
+            {
+                compact[i] = out;
+                points->at(out++) = points->at(i);
+            }
+        }
+
+        points->resize(out);
+
+        SegmentSoA welded(points);
+        welded.reserve(lines->size());
+
+        int numLines = lines->size();
+        for (int i = 0; i < numLines; i++)
+        {
+            Index a = compact[canonical[lines->i1[i]]];
+            Index b = compact[canonical[lines->i2[i]]];
+
+            // Lines between merged points.
+            if (a != b)
+            {
+                welded.push_back(a, b);
+            }
+        }
+
+        welded.splits = lines->splits;
+        lines->swap(welded);
+        removeDuplicateLines(lines);
+    }
+
+    // Sort key of the pair of point indices a <= b. 32 bit indices are packed into one integer.
+#ifdef SCRIB_64_BIT_INDICES
+    typedef std::pair<Index, Index> Line_Key;
+
+    static inline Line_Key line_key(Index a, Index b)
+    {
+        return Line_Key(a, b);
+    }
+#else
+    typedef uint64_t Line_Key;
+
+    static inline Line_Key line_key(Index a, Index b)
+    {
+        return ((uint64_t)a << 32) | b;
+    }
+#endif
+
+    void removeDuplicateLines(SegmentSoA * lines)
+    {
+        int len = lines->size();
+
+        // Sort the lines by their unordered pair of end point indices, ties are broken by position.
+        std::vector< std::pair<Line_Key, int> > keys(len);
+        for (int i = 0; i < len; i++)
+        {
+            Index a = min(lines->i1[i], lines->i2[i]);
+            Index b = max(lines->i1[i], lines->i2[i]);
+            keys[i] = std::pair<Line_Key, int>(line_key(a, b), i);
+        }
+
+        std::sort(keys.begin(), keys.end());
+
+        std::vector<bool> duplicate(len, false);
+        bool found = false;
+        for (int i = 1; i < len; i++)
+        {
+            if (keys[i].first == keys[i - 1].first)
+            {
+                duplicate[keys[i].second] = true;
+                found = true;
+            }
+        }
+
+        if (!found)
+        {
+            return;
+        }
+
+        int out = 0;
+        for (int i = 0; i < len; i++)
+        {
+            if (!duplicate[i])
+            {
+                lines->move(i, out++);
+            }
+        }
+
+        lines->resize(out);
+    }
+
+}
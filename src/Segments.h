@@ -0,0 +1,202 @@
+#ifndef SEGMENTS_H
+#define SEGMENTS_H
+
+#include <vector>
+#include "ofMain.h"
+#include "Index.h"
+
+/**
+* Line Representation and methods class.
+* First Draft completed by Bryce Summers on 7/14/2015.
+*
+* 10/17/2026: Lines are stored together in a structure of arrays of 2D float end points and 32 bit end point indices,
+*             which takes 24 bytes per line and no per line heap state, instead of one scrib::Line object per line
+*             with 3D points, an offset, a pointer to the global points and a vtable.
+*             The same store is used by the intersector, the SIMD kernel and both embedders.
+*
+* 10/17/2026: End point indices are scrib::Index values. Positions of lines within a list remain ints.
+*
+* 10/17/2026: Lines sharing an end point that fold back along each other, e.g. (0, 0) -> (10, 0) -> (5, 0), split each other.
+*/
+
+namespace scrib
+{
+
+    class SplitBuffer;
+
+    // Structure of arrays store for a list of lines between indexed points.
+    class SegmentSoA
+    {
+    public:
+
+        SegmentSoA();
+
+        // An empty list of lines between the given points.
+        SegmentSoA(std::vector<ofPoint> * points_global);
+
+        void clear();
+        void reserve(size_t size);
+
+        // Appends the line from the point at index start_point to the point at index end_point.
+        // REQUIRES: The global points are set.
+        void push_back(Index start_point, Index end_point);
+
+        // Appends a copy of the line at the given position of the other list.
+        void push_back(SegmentSoA & other, int position);
+
+        // Overwrites the line at position to with the line at position from, used to compact the lines in place.
+        void move(int from, int to);
+
+        // Removes the lines from the given size onwards.
+        // The bounding box is left as is, which is still a valid bound.
+        void resize(size_t size);
+
+        void swap(SegmentSoA & other);
+
+        size_t size()
+        {
+            return x1.size();
+        }
+
+        bool empty()
+        {
+            return x1.empty();
+        }
+
+        // Returns true iff the lines at the given positions share an end point index.
+        bool connected(int a, int b)
+        {
+            return i1[a] == i1[b] || i1[a] == i2[b] ||
+                   i2[a] == i1[b] || i2[a] == i2[b];
+        }
+
+        // Returns -1, 0 or 1 indicating which direction the given point is relative to the line at the given position.
+        // Exact, 0 is only returned for points exactly on the line.
+        int side(int position, float x, float y);
+
+        // Returns true iff the given point lies strictly between the end points of the line at the given position.
+        // REQUIRES: The point lies on the line's supporting line, e.g. side returned 0 for it.
+        bool between(int position, float x, float y);
+
+        // Returns true iff a call to intersect with the given lines would split them.
+        // Does not modify either line.
+        bool crosses(int a, int b);
+
+        /** Intersects the lines at the given positions.
+        *  If they cross, a new crossing point is added to the global points and both lines are split at it.
+        *  An end point touching the interior of the other line splits that line at the existing point.
+        *  Lines sharing an end point index only split each other if they are collinear and fold back along each other,
+        *  in which case the far end point of the shorter line splits the longer line.
+        *  Returns true iff the lines intersect.
+        *  REQUIRES: The lines have been attached to a SplitBuffer.
+        */
+        bool intersect(int a, int b)
+        {
+            return intersect(*this, a, *this, b);
+        }
+
+        // Intersects lines from two lists that share the same global points,
+        // each split line being recorded in the split buffer of its own list.
+        static bool intersect(SegmentSoA & lines_a, int a, SegmentSoA & lines_b, int b);
+
+        float length(int position)
+        {
+            float dx = x2[position] - x1[position];
+            float dy = y2[position] - y1[position];
+            return sqrt(dx*dx + dy*dy);
+        }
+
+        // End point coordinates.
+        std::vector<float> x1;
+        std::vector<float> y1;
+        std::vector<float> x2;
+        std::vector<float> y2;
+
+        // End point indices into the global points.
+        std::vector<Index> i1;
+        std::vector<Index> i2;
+
+        // The canonical array of points. Crossing points are appended to it.
+        std::vector<ofPoint> * points;
+
+        // Records the split points of these lines. NULL until attached by SplitBuffer::attach.
+        SplitBuffer * splits;
+
+        // Bounding box of all of the lines and the longest extents of any one line,
+        // used to bound the rounding error of the SIMD side tests.
+        float min_x;
+        float max_x;
+        float min_y;
+        float max_y;
+        float max_dx;
+        float max_dy;
+
+    private:
+
+        void push_back(float px1, float py1, float px2, float py2, Index start_point, Index end_point);
+
+        // Splits both lines at a newly created crossing point.
+        static void report_crossing(SegmentSoA & lines_a, int a, SegmentSoA & lines_b, int b);
+
+        // Splits the line at an existing point on it, found by the other line, if the point is strictly between the end points.
+        void report_touch(int position, float x, float y, Index point_index, int other);
+    };
+
+    // One split point on a line, found when intersecting it with another line.
+    struct Split_Record
+    {
+        // Indices of the split line and the line that split it, within their lists of lines.
+        int line;
+        int other;
+
+        // Position of the split point between the first and second end points of the split line, from 0 to 1.
+        // Only used to order the split points.
+        float per;
+
+        // Index of the split point.
+        Index point;
+    };
+
+    // Collects the split points of a list of lines in one compact array,
+    // instead of every line growing its own arrays as it is intersected.
+    class SplitBuffer
+    {
+    public:
+
+        // Records the split points of the given lines in this buffer. Forgets any previous records.
+        void attach(SegmentSoA * lines);
+
+        // Appends the split lines of every one of the attached lines to the output in order.
+        // Lines without split points are appended as they are.
+        // Lines are oriented along the polyline, such that i1 comes before i2 in the polyline + intersection point ordering.
+        void getSplitLines(SegmentSoA & lines, SegmentSoA * output);
+
+        void clear()
+        {
+            records.clear();
+        }
+
+        void add(int line, int other, float per, Index point)
+        {
+            Split_Record record = {line, other, per, point};
+            records.push_back(record);
+        }
+
+        // Sorts the records by line, then by position along the line, with a radix sort.
+        void sort();
+
+        std::vector<Split_Record> records;
+    };
+
+    // Gives points with identical coordinates a single index, such as the crossing points created where three or more lines
+    // cross at one point, or where two lines cross exactly at the end point of a third line.
+    // The lines of length 0 and duplicate lines that result are removed and the points are compacted, keeping their order.
+    void mergeCoincidentPoints(std::vector<ofPoint> * points, SegmentSoA * lines);
+
+    // Removes all but the first copy of lines connecting the same pair of points, in either direction.
+    // Preserves the order of the remaining lines.
+    void removeDuplicateLines(SegmentSoA * lines);
+
+}
+
+#endif // SEGMENTS_H
@@ -0,0 +1,289 @@
+/*
+*  SnapRounding.cpp
+*
+*  Written on 10/17/2026.
+*
+*/
+
+#include "SnapRounding.h"
+#include <math.h>
+#include <algorithm>
+
+namespace scrib
+{
+
+    // Orders by x, then y. Pixels centered at input points come before the crossing pixels at the same place.
+    static bool hot_pixel_less(const SnapRounder::Hot_Pixel & a, const SnapRounder::Hot_Pixel & b)
+    {
+        if (a.x != b.x)
+        {
+            return a.x < b.x;
+        }
+
+        if (a.y != b.y)
+        {
+            return a.y < b.y;
+        }
+
+        return a.index < b.index;
+    }
+
+    static bool hot_pixel_equal(const SnapRounder::Hot_Pixel & a, const SnapRounder::Hot_Pixel & b)
+    {
+        return a.x == b.x && a.y == b.y;
+    }
+
+    // Rounds towards negative infinity, for a positive denominator.
+    static inline int64_t floor_divide(int64_t numerator, int64_t denominator)
+    {
+        int64_t quotient = numerator / denominator;
+
+        if (numerator % denominator != 0 && numerator < 0)
+        {
+            quotient--;
+        }
+
+        return quotient;
+    }
+
+    struct Route_Point
+    {
+        // Position along the line, scaled by the squared length of the line.
+        int64_t time;
+        Index index;
+
+        bool operator<(const Route_Point & other) const
+        {
+            return time < other.time || (time == other.time && index < other.index);
+        }
+    };
+
+    float SnapRounder::snapCoordinate(float value)
+    {
+        double rounded = floor((double)value + 0.5);
+        rounded = std::min(rounded, (double)COORDINATE_LIMIT);
+        rounded = std::max(rounded, (double)-COORDINATE_LIMIT);
+        return (float)rounded;
+    }
+
+    void SnapRounder::snapRound(std::vector<ofPoint> * points, SegmentSoA * lines, Intersection_Algorithm algorithm)
+    {
+        findHotPixels(points, lines, algorithm);
+
+        SegmentSoA routed(points);
+        routed.reserve(lines -> size());
+
+        int len = lines -> size();
+        for (int i = 0; i < len; i++)
+        {
+            routeLine(*lines, i, &routed);
+        }
+
+        lines -> swap(routed);
+        hot_pixels.clear();
+    }
+
+    void SnapRounder::findHotPixels(std::vector<ofPoint> * points, SegmentSoA * lines, Intersection_Algorithm algorithm)
+    {
+        hot_pixels.clear();
+
+        Index num_points = points -> size();
+        for (Index i = 0; i < num_points; i++)
+        {
+            ofPoint & point = points -> at(i);
+            Hot_Pixel pixel = {(int64_t)point.x, (int64_t)point.y, i};
+            hot_pixels.push_back(pixel);
+        }
+
+        // The crossings are found by intersecting copies of the lines with the requested algorithm.
+        // Each crossing creates one new point, which is recorded once for each of the two lines that cross there.
+        SegmentSoA copies(points);
+        copies.reserve(lines -> size());
+
+        int len = lines -> size();
+        for (int i = 0; i < len; i++)
+        {
+            copies.push_back(*lines, i);
+        }
+
+        SplitBuffer splits;
+        splits.attach(&copies);
+
+        Intersector intersector;
+        intersector.setNumThreads(num_threads);
+        intersector.intersect(&copies, algorithm);
+
+        int numRecords = splits.records.size();
+        for (int i = 0; i < numRecords; i++)
+        {
+            Split_Record & record = splits.records[i];
+
+            // Touches split lines at existing points, which are already hot pixels.
+            if (record.point < num_points || record.line > record.other)
+            {
+                continue;
+            }
+
+            addCrossingPixel(*lines, record.line, record.other);
+        }
+
+        // The crossing points were only approximate, the exact hot pixels have been found.
+        points -> resize(num_points);
+
+        std::sort(hot_pixels.begin(), hot_pixels.end(), hot_pixel_less);
+        hot_pixels.erase(std::unique(hot_pixels.begin(), hot_pixels.end(), hot_pixel_equal), hot_pixels.end());
+
+        // Crossing pixels that are not centered at an input point get a new point.
+        len = hot_pixels.size();
+        for (int i = 0; i < len; i++)
+        {
+            Hot_Pixel & pixel = hot_pixels[i];
+
+            if (pixel.index == NULL_ID)
+            {
+                pixel.index = points -> size();
+                points -> push_back(ofPoint((float)pixel.x, (float)pixel.y));
+            }
+        }
+    }
+
+    void SnapRounder::addCrossingPixel(SegmentSoA & lines, int a, int b)
+    {
+        int64_t ax = (int64_t)lines.x1[a];
+        int64_t ay = (int64_t)lines.y1[a];
+        int64_t adx = (int64_t)lines.x2[a] - ax;
+        int64_t ady = (int64_t)lines.y2[a] - ay;
+
+        int64_t bx = (int64_t)lines.x1[b];
+        int64_t by = (int64_t)lines.y1[b];
+        int64_t bdx = (int64_t)lines.x2[b] - bx;
+        int64_t bdy = (int64_t)lines.y2[b] - by;
+
+        // The crossing is at the first end point of a + (the offset of a) * numerator / denominator.
+        int64_t denominator = adx * bdy - ady * bdx;
+        int64_t numerator   = (bx - ax) * bdy - (by - ay) * bdx;
+
+        // Parallel lines do not properly cross.
+        if (denominator == 0)
+        {
+            return;
+        }
+
+        if (denominator < 0)
+        {
+            denominator = -denominator;
+            numerator   = -numerator;
+        }
+
+        // Rounds halves up: floor(d * t + 1/2) = floor((2 d numerator + denominator) / (2 denominator)).
+        Hot_Pixel pixel;
+        pixel.x = ax + floor_divide(2 * adx * numerator + denominator, 2 * denominator);
+        pixel.y = ay + floor_divide(2 * ady * numerator + denominator, 2 * denominator);
+        pixel.index = NULL_ID;
+
+        hot_pixels.push_back(pixel);
+    }
+
+    // The side of the line through the origin with direction (dx, dy) that the doubled point (x, y) is on.
+    static inline int side(int64_t dx, int64_t dy, int64_t x, int64_t y)
+    {
+        int64_t det = dx * y - dy * x;
+        return (det > 0) - (det < 0);
+    }
+
+    bool SnapRounder::passesThrough(int64_t dx, int64_t dy, int64_t px, int64_t py)
+    {
+        // The corners are at half integers, so the side tests are done in doubled coordinates.
+        int64_t cx = 2 * px;
+        int64_t cy = 2 * py;
+        int bottom_left  = side(dx, dy, cx - 1, cy - 1);
+        int bottom_right = side(dx, dy, cx + 1, cy - 1);
+        int top_left     = side(dx, dy, cx - 1, cy + 1);
+        int top_right    = side(dx, dy, cx + 1, cy + 1);
+
+        // Every corner strictly on one side, the line misses the closed square.
+        if (bottom_left == bottom_right && bottom_right == top_left && top_left == top_right && top_right != 0)
+        {
+            return false;
+        }
+
+        // The caller has checked that the center is within the bounding box of the line, whose end points are grid points.
+        // The line therefore meets the closed square, but it may only touch it at a corner.
+        // Pixels are half open, containing their left and bottom edges, so only the bottom left corner counts as a touch.
+        if (bottom_right == 0 && bottom_left == top_left && top_left == top_right)
+        {
+            return false;
+        }
+
+        if (top_left == 0 && bottom_left == bottom_right && bottom_right == top_right)
+        {
+            return false;
+        }
+
+        if (top_right == 0 && bottom_left == bottom_right && bottom_right == top_left)
+        {
+            return false;
+        }
+
+        return true;
+    }
+
+    void SnapRounder::routeLine(SegmentSoA & lines, int position, SegmentSoA * output)
+    {
+        int64_t ax = (int64_t)lines.x1[position];
+        int64_t ay = (int64_t)lines.y1[position];
+        int64_t bx = (int64_t)lines.x2[position];
+        int64_t by = (int64_t)lines.y2[position];
+        int64_t dx = bx - ax;
+        int64_t dy = by - ay;
+
+        // Hot pixels are unit squares centered at grid points,
+        // so only the pixels centered within the bounding box of the line can be hit.
+        int64_t min_x = std::min(ax, bx);
+        int64_t max_x = std::max(ax, bx);
+        int64_t min_y = std::min(ay, by);
+        int64_t max_y = std::max(ay, by);
+
+        std::vector<Route_Point> route;
+
+        Hot_Pixel start = {min_x, min_y, 0};
+        std::vector<Hot_Pixel>::iterator iter = std::lower_bound(hot_pixels.begin(), hot_pixels.end(), start, hot_pixel_less);
+
+        for (; iter != hot_pixels.end() && iter -> x <= max_x; ++iter)
+        {
+            int64_t px = iter -> x;
+            int64_t py = iter -> y;
+
+            if (py < min_y || py > max_y)
+            {
+                continue;
+            }
+
+            if ((px == ax && py == ay) || (px == bx && py == by))
+            {
+                continue;
+            }
+
+            if (!passesThrough(dx, dy, px - ax, py - ay))
+            {
+                continue;
+            }
+
+            Route_Point point = {dx * (px - ax) + dy * (py - ay), iter -> index};
+            route.push_back(point);
+        }
+
+        std::sort(route.begin(), route.end());
+
+        Index previous = lines.i1[position];
+        int len = route.size();
+        for (int i = 0; i < len; i++)
+        {
+            output -> push_back(previous, route[i].index);
+            previous = route[i].index;
+        }
+
+        output -> push_back(previous, lines.i2[position]);
+    }
+
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+/*
+* Integer Snap Rounding.
+*
+* Written on 10/17/2026.
+*
+* Purpose: Embeds polylines drawn on an integer grid, such as pixel or tablet coordinates, so that every output vertex is
+*          also on the grid.
+*
+* Uses hot pixel snap rounding. (See Hobby, "Practical segment intersection with finite precision output".)
+* The unit square centered at every input point and at the grid point nearest to every crossing is a hot pixel.
+* Every line is then rerouted through the centers of the hot pixels that it passes through, in order along the line.
+* The rerouted lines never cross each other, they may only touch or overlap at hot pixel centers,
+* so the remaining splitting is done exactly at existing points by the regular Intersector.
+*
+* All of the tests use 64 bit integer arithmetic on the integer coordinates, which is exact as long as
+* every coordinate is within COORDINATE_LIMIT.
+*/
+
+#include <vector>
+#include <stdint.h>
+#include "ofMain.h"
+#include "Segments.h"
+#include "Intersector.h"
+
+namespace scrib
+{
+
+    class SnapRounder
+    {
+    public:
+
+        SnapRounder()
+        {
+            num_threads = 0;
+        };
+        virtual ~SnapRounder() {};
+
+        // The half open unit square [x - 1/2, x + 1/2) x [y - 1/2, y + 1/2) centered at a grid point.
+        // Hot pixels do not overlap, so every point is in exactly one of them.
+        struct Hot_Pixel
+        {
+            int64_t x;
+            int64_t y;
+
+            // The index of the point at the center of this pixel, NULL_ID until a point is created for it.
+            Index index;
+        };
+
+        // Coordinates are clamped to +-COORDINATE_LIMIT, which keeps every crossing computation within 64 bits.
+        static const int COORDINATE_LIMIT = 1 << 19;
+
+        // Rounds the given coordinate to the nearest grid point within the coordinate limit.
+        static float snapCoordinate(float value);
+
+        // Number of threads used by the PARALLEL_SWEEP_LINE algorithm while finding the crossings.
+        void setNumThreads(int num_threads)
+        {
+            this -> num_threads = num_threads;
+        }
+
+        // REQUIRES: Every point is on the grid, i.e. has been passed through snapCoordinate.
+        // Replaces the lines with the rerouted lines in polyline order.
+        // The centers of new hot pixels are appended to the points.
+        void snapRound(std::vector<ofPoint> * points, SegmentSoA * lines, Intersection_Algorithm algorithm);
+
+    private:
+
+        int num_threads;
+
+        // Sorted by x, then y, without duplicates.
+        std::vector<Hot_Pixel> hot_pixels;
+
+        // Finds the crossings with the given algorithm and adds the hot pixels for them and for every input point.
+        void findHotPixels(std::vector<ofPoint> * points, SegmentSoA * lines, Intersection_Algorithm algorithm);
+
+        // Adds the hot pixel containing the crossing point of the given properly crossing lines.
+        void addCrossingPixel(SegmentSoA & lines, int a, int b);
+
+        // Returns true iff the line from the origin with the given direction passes through the hot pixel centered at (px, py).
+        // REQUIRES: The center is within the bounding box of the line.
+        static bool passesThrough(int64_t dx, int64_t dy, int64_t px, int64_t py);
+
+        // Appends the given line split at the centers of the hot pixels that it passes through, other than its own end points.
+        void routeLine(SegmentSoA & lines, int position, SegmentSoA * output);
+    };
+
+}
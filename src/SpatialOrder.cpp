@@ -0,0 +1,293 @@
+/*
+*  SpatialOrder.cpp
+*
+*  Written on 10/17/2026.
+*
+*/
+
+#include "SpatialOrder.h"
+#include <algorithm>
+
+namespace scrib
+{
+
+    // Side length of the Hilbert curve grid.
+    static const uint32_t HILBERT_SIZE = 1 << 16;
+
+    uint32_t hilbertIndex(uint32_t x, uint32_t y)
+    {
+        uint32_t index = 0;
+
+        for (uint32_t s = HILBERT_SIZE / 2; s > 0; s /= 2)
+        {
+            uint32_t rx = (x & s) > 0;
+            uint32_t ry = (y & s) > 0;
+            index += s * s * ((3 * rx) ^ ry);
+
+            // Rotate the quadrant, so that the curve within it starts and ends at the right corners.
+            if (ry == 0)
+            {
+                if (rx == 1)
+                {
+                    x = HILBERT_SIZE - 1 - x;
+                    y = HILBERT_SIZE - 1 - y;
+                }
+
+                std::swap(x, y);
+            }
+        }
+
+        return index;
+    }
+
+    // Maps points within the bounds of the vertices to grid cells along the Hilbert curve.
+    class Hilbert_Grid
+    {
+    public:
+
+        Hilbert_Grid(Graph * graph)
+        {
+            min_x = min_y = 0;
+            scale_x = scale_y = 0;
+
+            Vertex_Iter iter = graph -> verticesBegin();
+            if (iter == graph -> verticesEnd())
+            {
+                return;
+            }
+
+            float max_x, max_y;
+            min_x = max_x = (*iter) -> data.point.x;
+            min_y = max_y = (*iter) -> data.point.y;
+
+            for (; iter != graph -> verticesEnd(); ++iter)
+            {
+                ofPoint & point = (*iter) -> data.point;
+                min_x = min(min_x, point.x);
+                max_x = max(max_x, point.x);
+                min_y = min(min_y, point.y);
+                max_y = max(max_y, point.y);
+            }
+
+            if (max_x > min_x)
+            {
+                scale_x = (HILBERT_SIZE - 1) / ((double)max_x - min_x);
+            }
+
+            if (max_y > min_y)
+            {
+                scale_y = (HILBERT_SIZE - 1) / ((double)max_y - min_y);
+            }
+        }
+
+        uint32_t key(double x, double y)
+        {
+            uint32_t cell_x = (uint32_t)((x - min_x) * scale_x);
+            uint32_t cell_y = (uint32_t)((y - min_y) * scale_y);
+            return hilbertIndex(min(cell_x, HILBERT_SIZE - 1), min(cell_y, HILBERT_SIZE - 1));
+        }
+
+    private:
+
+        float min_x;
+        float min_y;
+        double scale_x;
+        double scale_y;
+    };
+
+    typedef std::pair<uint32_t, Index> Keyed_ID;
+
+    // Larger than every Hilbert index, so removed elements are moved after every live element.
+    static const uint32_t REMOVED_KEY = 0xFFFFFFFF;
+
+    // Sorts the keyed old IDs and returns the new ID of every old ID. Ties keep their old order.
+    static void rank(std::vector<Keyed_ID> & keys, std::vector<Index> & new_IDs)
+    {
+        std::sort(keys.begin(), keys.end());
+
+        Index len = keys.size();
+        new_IDs.resize(len);
+        for (Index i = 0; i < len; i++)
+        {
+            new_IDs[keys[i].second] = i;
+        }
+    }
+
+    // Composes the old permutation with the new IDs of the elements.
+    static void record(std::vector<Index> & new_IDs, std::vector<Index> & original, std::vector<Index> & current)
+    {
+        Index len = new_IDs.size();
+        std::vector<Index> new_original(len);
+
+        for (Index i = 0; i < len; i++)
+        {
+            new_original[new_IDs[i]] = original.empty() ? i : original[i];
+        }
+
+        // Before the first relabeling the original IDs are the current IDs.
+        // Afterwards there is one current ID per original element, which is NULL_ID once it was removed, see GraphMutator.h.
+        if (original.empty())
+        {
+            current.resize(len);
+        }
+
+        original.swap(new_original);
+
+        std::fill(current.begin(), current.end(), NULL_ID);
+        for (Index i = 0; i < len; i++)
+        {
+            // Elements added since the graph was embedded have no original ID.
+            if (original[i] != NULL_ID)
+            {
+                current[original[i]] = i;
+            }
+        }
+    }
+
+    void relabelSpatially(Graph * graph)
+    {
+        Hilbert_Grid grid(graph);
+
+        // -- Vertices.
+        Index num_vertices = graph -> numVertices();
+        std::vector<uint32_t> vertex_keys(num_vertices);
+        std::vector<Keyed_ID> keys(num_vertices);
+        for (Index i = 0; i < num_vertices; i++)
+        {
+            Vertex * vertex = graph -> getVertex(i);
+            vertex_keys[i] = vertex -> ID == NULL_ID ? REMOVED_KEY : grid.key(vertex -> data.point.x, vertex -> data.point.y);
+            keys[i] = Keyed_ID(vertex_keys[i], i);
+        }
+
+        std::vector<Index> vertex_IDs;
+        rank(keys, vertex_IDs);
+
+        // -- Halfedges, the halfedges leaving a vertex stay together.
+        Index num_halfedges = graph -> numHalfedges();
+        keys.resize(num_halfedges);
+        for (Index i = 0; i < num_halfedges; i++)
+        {
+            Halfedge * halfedge = graph -> getHalfedge(i);
+            keys[i] = Keyed_ID(halfedge -> ID == NULL_ID ? REMOVED_KEY : vertex_keys[halfedge -> vertex], i);
+        }
+
+        std::vector<Index> halfedge_IDs;
+        rank(keys, halfedge_IDs);
+
+        // -- Edges, by midpoint.
+        Index num_edges = graph -> numEdges();
+        keys.resize(num_edges);
+        for (Index i = 0; i < num_edges; i++)
+        {
+            Edge * edge = graph -> getEdge(i);
+            if (edge -> ID == NULL_ID)
+            {
+                keys[i] = Keyed_ID(REMOVED_KEY, i);
+                continue;
+            }
+
+            Halfedge * halfedge = graph -> getHalfedge(edge -> halfedge);
+            ofPoint & p1 = graph -> getVertex(halfedge -> vertex) -> data.point;
+            ofPoint & p2 = graph -> getVertex(graph -> getHalfedge(halfedge -> twin) -> vertex) -> data.point;
+            keys[i] = Keyed_ID(grid.key(((double)p1.x + p2.x) / 2, ((double)p1.y + p2.y) / 2), i);
+        }
+
+        std::vector<Index> edge_IDs;
+        rank(keys, edge_IDs);
+
+        // -- Faces, by the centroid of the vertices around them.
+        Index num_faces = graph -> numFaces();
+        keys.resize(num_faces);
+        for (Index i = 0; i < num_faces; i++)
+        {
+            Face * face = graph -> getFace(i);
+            if (face -> ID == NULL_ID)
+            {
+                keys[i] = Keyed_ID(REMOVED_KEY, i);
+                continue;
+            }
+
+            Index start   = face -> halfedge;
+            Index current = start;
+            double x = 0;
+            double y = 0;
+            double count = 0;
+
+            do
+            {
+                Halfedge * halfedge = graph -> getHalfedge(current);
+                ofPoint & point = graph -> getVertex(halfedge -> vertex) -> data.point;
+                x += point.x;
+                y += point.y;
+                count++;
+                current = halfedge -> next;
+            } while (current != start);
+
+            keys[i] = Keyed_ID(grid.key(x / count, y / count), i);
+        }
+
+        std::vector<Index> face_IDs;
+        rank(keys, face_IDs);
+
+        graph -> permute(vertex_IDs, edge_IDs, halfedge_IDs, face_IDs);
+
+        // -- The IDs stored in the associated data.
+        for (Face_Iter iter = graph -> facesBegin(); iter != graph -> facesEnd(); ++iter)
+        {
+            Face_Data & data = (*iter) -> data;
+            data.first_hole = Graph::remap(face_IDs, data.first_hole);
+            data.next_hole  = Graph::remap(face_IDs, data.next_hole);
+        }
+
+        for (Halfedge_Iter iter = graph -> halfedgesBegin(); iter != graph -> halfedgesEnd(); ++iter)
+        {
+            Halfedge_Data & data = (*iter) -> data;
+            data.next_extraordinary = Graph::remap(halfedge_IDs, data.next_extraordinary);
+        }
+
+        // -- The kept vertex stars move with their vertices.
+        Vertex_Stars & stars = graph -> data -> stars;
+        if (!stars.empty())
+        {
+            Vertex_Stars relabeled;
+            relabeled.offsets.assign(num_vertices + 1, 0);
+            relabeled.halfedges.resize(stars.halfedges.size());
+
+            for (Index i = 0; i < num_vertices; i++)
+            {
+                relabeled.offsets[vertex_IDs[i] + 1] = stars.degree(i);
+            }
+
+            for (Index i = 0; i < num_vertices; i++)
+            {
+                relabeled.offsets[i + 1] += relabeled.offsets[i];
+            }
+
+            for (Index i = 0; i < num_vertices; i++)
+            {
+                Index out = relabeled.offsets[vertex_IDs[i]];
+                for (Index h = stars.offsets[i]; h < stars.offsets[i + 1]; h++)
+                {
+                    relabeled.halfedges[out++] = halfedge_IDs[stars.halfedges[h]];
+                }
+            }
+
+            stars.offsets.swap(relabeled.offsets);
+            stars.halfedges.swap(relabeled.halfedges);
+        }
+
+        // -- The chain view stores halfedge and vertex IDs in every chain, so it is traced again.
+        Chain_View & chains = graph -> data -> chains;
+        if (!chains.empty())
+        {
+            chains.build(graph);
+        }
+
+        Graph_Permutation & permutation = graph -> data -> permutation;
+        record(vertex_IDs,   permutation.original_vertices,  permutation.current_vertices);
+        record(edge_IDs,     permutation.original_edges,     permutation.current_edges);
+        record(halfedge_IDs, permutation.original_halfedges, permutation.current_halfedges);
+        record(face_IDs,     permutation.original_faces,     permutation.current_faces);
+    }
+
+}
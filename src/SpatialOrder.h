@@ -0,0 +1,39 @@
+#pragma once
+
+/*
+* Spatial Ordering of Graph Elements.
+*
+* Written on 10/17/2026.
+*
+* Purpose: The embedder numbers the vertices as input points, then intersection points, and the halfedges as
+*          forward halfedges, then backward halfedges, so elements that are next to each other in the plane are often far apart
+*          in memory. Relabeling the elements along a Hilbert curve keeps the elements visited by a face traversal close together.
+*
+* Vertices are ordered by their points, halfedges by the points of their vertices, edges by their midpoints
+* and faces by the centroids of their vertices.
+* The original IDs remain available through the Graph_Permutation recorded in the Graph_Data.
+*
+* Removed elements are moved after all of the live elements of their type.
+*
+* NOTE: A relabeled graph no longer keeps the embedder's ordering invariants,
+*       e.g. forward halfedges are no longer the first half of the halfedges and the IDs of edges no longer follow the input.
+*/
+
+#include <vector>
+#include <stdint.h>
+#include "ofMain.h"
+#include "HalfedgeGraph.h"
+#include "PolylineGraphData.h"
+
+namespace scrib
+{
+
+    // Renumbers every element of the given graph in Hilbert curve order and rewrites every link.
+    // The original IDs are recorded in graph -> data -> permutation. If the graph was already relabeled,
+    // the permutation still relates the elements to the IDs they had before the first relabeling.
+    void relabelSpatially(Graph * graph);
+
+    // Returns the position along a Hilbert curve through a 2^16 by 2^16 grid of the given grid cell.
+    uint32_t hilbertIndex(uint32_t x, uint32_t y);
+
+}
@@ -0,0 +1,424 @@
+/*
+* Intersection Tests.
+*
+* Written on 10/17/2026.
+*
+* Checks every Intersection_Algorithm against intersect_brute_force, which is the reference for the split lines,
+* along with the embeddings of known degenerate inputs.
+*
+* Build this file with the addon's src files and openFrameworks, like the example project, and run it.
+* Returns 0 iff every test passes. Failures are reported on the standard output.
+*/
+
+#include "ofMain.h"
+#include "PolylineGraphMain.h"
+#include "Predicates.h"
+#include <algorithm>
+#include <iterator>
+#include <sstream>
+
+using namespace scrib;
+
+typedef std::vector< std::vector<ofPoint> > Polyline_Set;
+
+// The end point coordinates of one split line, with the lexicographically smaller end point first.
+struct Coordinate_Line
+{
+    float x1;
+    float y1;
+    float x2;
+    float y2;
+
+    bool operator<(const Coordinate_Line & other) const
+    {
+        if (x1 != other.x1)
+        {
+            return x1 < other.x1;
+        }
+
+        if (y1 != other.y1)
+        {
+            return y1 < other.y1;
+        }
+
+        if (x2 != other.x2)
+        {
+            return x2 < other.x2;
+        }
+
+        return y2 < other.y2;
+    }
+
+    bool operator==(const Coordinate_Line & other) const
+    {
+        return x1 == other.x1 && y1 == other.y1 && x2 == other.x2 && y2 == other.y2;
+    }
+};
+
+static const Intersection_Algorithm ALGORITHMS[] = {SWEEP_LINE, PARALLEL_SWEEP_LINE, UNIFORM_GRID, MONOTONE_CHAINS, POLYLINE_BVH};
+static const char * ALGORITHM_NAMES[] = {"BRUTE_FORCE", "SWEEP_LINE", "PARALLEL_SWEEP_LINE", "UNIFORM_GRID", "MONOTONE_CHAINS", "POLYLINE_BVH"};
+
+static int failures = 0;
+
+static void fail(const std::string & test, const std::string & message)
+{
+    cout << "FAILED " << test << ": " << message << endl;
+    failures++;
+}
+
+// Splits the given polylines with the given algorithm, just like the PolylineGraphEmbedder does,
+// and returns the split lines sorted by their coordinates, which do not depend on the order the splits were found in.
+static std::vector<Coordinate_Line> splitLines(Polyline_Set & polylines, Intersection_Algorithm algorithm)
+{
+    std::vector<ofPoint> points;
+    SegmentSoA lines(&points);
+
+    for (size_t i = 0; i < polylines.size(); i++)
+    {
+        size_t offset = points.size();
+        points.insert(points.end(), polylines[i].begin(), polylines[i].end());
+
+        for (size_t p = offset + 1; p < points.size(); p++)
+        {
+            lines.push_back((Index)(p - 1), (Index)p);
+        }
+    }
+
+    SplitBuffer splits;
+    splits.attach(&lines);
+
+    // A fixed number of threads, so that PARALLEL_SWEEP_LINE sweeps large inputs in slabs even on a single core.
+    Intersector intersector;
+    intersector.setNumThreads(4);
+    intersector.intersect(&lines, algorithm);
+
+    SegmentSoA split(&points);
+    splits.getSplitLines(lines, &split);
+    mergeCoincidentPoints(&points, &split);
+
+    std::vector<Coordinate_Line> output;
+    for (size_t i = 0; i < split.size(); i++)
+    {
+        Coordinate_Line line = {split.x1[i], split.y1[i], split.x2[i], split.y2[i]};
+
+        if (sweep_before(line.x2, line.y2, line.x1, line.y1))
+        {
+            std::swap(line.x1, line.x2);
+            std::swap(line.y1, line.y2);
+        }
+
+        output.push_back(line);
+    }
+
+    std::sort(output.begin(), output.end());
+    return output;
+}
+
+static std::string describe(const Coordinate_Line & line)
+{
+    std::ostringstream out;
+    out << "(" << line.x1 << ", " << line.y1 << ")-(" << line.x2 << ", " << line.y2 << ")";
+    return out.str();
+}
+
+// Every algorithm must split the lines exactly like the brute force algorithm.
+static void checkAgainstBruteForce(const std::string & test, Polyline_Set & polylines)
+{
+    std::vector<Coordinate_Line> expected = splitLines(polylines, BRUTE_FORCE);
+
+    for (size_t a = 0; a < sizeof(ALGORITHMS) / sizeof(ALGORITHMS[0]); a++)
+    {
+        std::vector<Coordinate_Line> actual = splitLines(polylines, ALGORITHMS[a]);
+
+        if (actual == expected)
+        {
+            continue;
+        }
+
+        std::vector<Coordinate_Line> missing;
+        std::vector<Coordinate_Line> extra;
+        std::set_difference(expected.begin(), expected.end(), actual.begin(), actual.end(), std::back_inserter(missing));
+        std::set_difference(actual.begin(), actual.end(), expected.begin(), expected.end(), std::back_inserter(extra));
+
+        std::string message = std::string(ALGORITHM_NAMES[ALGORITHMS[a]]) + " differs from BRUTE_FORCE,";
+        message += missing.empty() ? " no missing line" : " missing " + describe(missing[0]);
+        message += extra.empty()   ? ", no extra line"  : ", extra " + describe(extra[0]);
+        fail(test, message);
+    }
+}
+
+// Every algorithm, including the brute force algorithm, must split the polylines into exactly the given lines.
+static void checkSplitLines(const std::string & test, Polyline_Set & polylines, const float * coordinates, int numLines)
+{
+    std::vector<Coordinate_Line> expected;
+    for (int i = 0; i < numLines; i++)
+    {
+        Coordinate_Line line = {coordinates[i * 4], coordinates[i * 4 + 1], coordinates[i * 4 + 2], coordinates[i * 4 + 3]};
+        expected.push_back(line);
+    }
+
+    std::sort(expected.begin(), expected.end());
+
+    for (int algorithm = BRUTE_FORCE; algorithm <= POLYLINE_BVH; algorithm++)
+    {
+        std::vector<Coordinate_Line> actual = splitLines(polylines, (Intersection_Algorithm)algorithm);
+
+        if (actual != expected)
+        {
+            fail(test, std::string(ALGORITHM_NAMES[algorithm]) + " found the wrong split lines");
+        }
+    }
+}
+
+// Every algorithm must embed the polylines into a graph with the given numbers of edges and faces.
+static void checkEmbedding(const std::string & test, Polyline_Set & polylines, size_t edges, size_t faces)
+{
+    std::vector< std::vector<ofPoint> *> inputs;
+    for (size_t i = 0; i < polylines.size(); i++)
+    {
+        inputs.push_back(&polylines[i]);
+    }
+
+    for (int algorithm = BRUTE_FORCE; algorithm <= POLYLINE_BVH; algorithm++)
+    {
+        PolylineGraphEmbedder embedder((Intersection_Algorithm)algorithm);
+        Graph * graph = embedder.embedPolylineSet(&inputs);
+
+        if (graph == NULL)
+        {
+            fail(test, std::string(ALGORITHM_NAMES[algorithm]) + " failed to embed the input");
+            continue;
+        }
+
+        if (graph -> numEdges() != edges || graph -> numFaces() != faces)
+        {
+            std::ostringstream out;
+            out << ALGORITHM_NAMES[algorithm] << " found " << graph -> numEdges() << " edges and " << graph -> numFaces()
+                << " faces instead of " << edges << " and " << faces;
+            fail(test, out.str());
+        }
+
+        delete graph;
+    }
+}
+
+static std::vector<ofPoint> polyline(const float * coordinates, int numPoints)
+{
+    std::vector<ofPoint> output;
+    for (int i = 0; i < numPoints; i++)
+    {
+        output.push_back(ofPoint(coordinates[i * 2], coordinates[i * 2 + 1]));
+    }
+
+    return output;
+}
+
+// A small linear congruential generator, so that the random inputs are the same on every platform.
+static unsigned int random_state = 1;
+
+static int randomInt(int range)
+{
+    random_state = random_state * 1103515245u + 12345u;
+    return (int)((random_state >> 16) % (unsigned int)range);
+}
+
+// Returns a random walk on the integer grid, with steps of up to 3 units in each direction.
+// Walks often run along a line and double back along themselves. Repeated points are skipped, like the embedder does.
+static std::vector<ofPoint> randomWalk(int numSteps, int range)
+{
+    std::vector<ofPoint> output;
+
+    int x = randomInt(range) - range / 2;
+    int y = randomInt(range) - range / 2;
+
+    for (int i = 0; i < numSteps; i++)
+    {
+        if (output.empty() || output.back().x != x || output.back().y != y)
+        {
+            output.push_back(ofPoint(x, y));
+        }
+
+        x += randomInt(7) - 3;
+        y += randomInt(7) - 3;
+    }
+
+    return output;
+}
+
+// -- Tests.
+
+// The end point of B touches A, but C lies between them along the sweep line, collinear with A.
+static void testTouchBeyondCollinearRun()
+{
+    const float a[] = {90, 55,  90, 85};
+    const float b[] = {90, 65,  30, 45};
+    const float c[] = {90,  5,  90, 80};
+
+    Polyline_Set input;
+    input.push_back(polyline(a, 2));
+    input.push_back(polyline(b, 2));
+    input.push_back(polyline(c, 2));
+
+    checkAgainstBruteForce("touch beyond a collinear run", input);
+    checkEmbedding("touch beyond a collinear run", input, 5, 1);
+}
+
+// The end point of the first line lies on the third line, which is collinear with the second line.
+static void testJointOnCollinearLine()
+{
+    const float a[] = {-31, 8,  -29, 15,  -30, 12,  -27, 21};
+
+    Polyline_Set input;
+    input.push_back(polyline(a, 4));
+
+    checkAgainstBruteForce("joint on a collinear line", input);
+}
+
+// Consecutive lines that fold back along each other are split at the far end point of the shorter line.
+static void testFoldBack()
+{
+    const float horizontal[] = {0, 0,  10, 0,  5, 0};
+    const float horizontal_lines[] = {0, 0, 5, 0,  5, 0, 10, 0};
+
+    const float diagonal[] = {0, 0,  10, 10,  -5, -5};
+    const float diagonal_lines[] = {-5, -5, 0, 0,  0, 0, 10, 10};
+
+    const float vertical[] = {0, 0,  0, 10,  0, 5};
+    const float vertical_lines[] = {0, 0, 0, 5,  0, 5, 0, 10};
+
+    Polyline_Set input;
+    input.push_back(polyline(horizontal, 3));
+    checkSplitLines("horizontal fold back", input, horizontal_lines, 2);
+
+    input[0] = polyline(diagonal, 3);
+    checkSplitLines("diagonal fold back", input, diagonal_lines, 2);
+
+    input[0] = polyline(vertical, 3);
+    checkSplitLines("vertical fold back", input, vertical_lines, 2);
+
+    // All three meet at (0, 0), along with two far apart copies, so that there are enough lines for the SIMD kernel.
+    // Every component is a tree with a single face.
+    const float offsets[] = {100, 200};
+    Polyline_Set copies;
+    copies.push_back(polyline(horizontal, 3));
+    copies.push_back(polyline(diagonal, 3));
+    copies.push_back(polyline(vertical, 3));
+
+    for (int i = 0; i < 2; i++)
+    {
+        copies.push_back(polyline(horizontal, 3));
+        for (size_t p = 0; p < copies.back().size(); p++)
+        {
+            copies.back()[p] += ofPoint(offsets[i], offsets[i]);
+        }
+    }
+
+    checkAgainstBruteForce("fold backs", copies);
+    checkEmbedding("fold backs", copies, 10, 3);
+}
+
+// Every algorithm must agree with the brute force algorithm on random integer walks,
+// which are full of collinear runs, fold backs and end points touching other lines.
+static void testRandomWalks()
+{
+    random_state = 1;
+
+    for (int seed = 0; seed < 200; seed++)
+    {
+        Polyline_Set input;
+        int numWalks = 1 + randomInt(3);
+        for (int i = 0; i < numWalks; i++)
+        {
+            input.push_back(randomWalk(20, 20));
+        }
+
+        std::ostringstream test;
+        test << "random walks " << seed;
+        checkAgainstBruteForce(test.str(), input);
+    }
+
+    // More than 1024 lines, so that PARALLEL_SWEEP_LINE sweeps in slabs.
+    for (int seed = 0; seed < 3; seed++)
+    {
+        Polyline_Set input;
+        input.push_back(randomWalk(1500, 60));
+
+        std::ostringstream test;
+        test << "long random walk " << seed;
+        checkAgainstBruteForce(test.str(), input);
+    }
+}
+
+// The orientation of exactly collinear points is 0 for every order of the points,
+// and points one unit in the last place off of the line are on the correct side.
+static void testOrientation()
+{
+    // Points near (0.5, 0.5) on a grid of spacing 2^-24, tested against the line y = x through (12, 12) and (24, 24).
+    // The double precision evaluation can not decide these, so they exercise the exact fallback.
+    const float ulp = 1.0f / (1 << 24);
+
+    for (int i = 0; i < 16; i++)
+    {
+        for (int j = 0; j < 16; j++)
+        {
+            float ax = 0.5f + i * ulp;
+            float ay = 0.5f + j * ulp;
+
+            // (ax, ay) is left of the line directed from (12, 12) to (24, 24) iff it lies above it.
+            int expected = (j > i) - (j < i);
+
+            if (orientation(12, 12, 24, 24, ax, ay) != expected ||
+                orientation(24, 24, ax, ay, 12, 12) != expected ||
+                orientation(ax, ay, 12, 12, 24, 24) != expected ||
+                orientation(24, 24, 12, 12, ax, ay) != -expected ||
+                orientation(12, 12, ax, ay, 24, 24) != -expected ||
+                orientation(ax, ay, 24, 24, 12, 12) != -expected)
+            {
+                std::ostringstream out;
+                out << "wrong orientation of (0.5 + " << i << " ulp, 0.5 + " << j << " ulp)";
+                fail("orientation", out.str());
+            }
+        }
+    }
+
+    // Exactly collinear points a + k d, with fractional coordinates that are all representable as floats.
+    for (int k = -8; k <= 8; k++)
+    {
+        float ax = 1024.5f;
+        float ay = -512.25f;
+        float dx = 3.0f / 64;
+        float dy = -5.0f / 128;
+
+        float bx = ax + 37 * dx;
+        float by = ay + 37 * dy;
+        float cx = ax + k * dx;
+        float cy = ay + k * dy;
+
+        if (orientation(ax, ay, bx, by, cx, cy) != 0 ||
+            orientation(bx, by, cx, cy, ax, ay) != 0 ||
+            orientation(cx, cy, bx, by, ax, ay) != 0)
+        {
+            std::ostringstream out;
+            out << "collinear point " << k << " is not collinear";
+            fail("orientation", out.str());
+        }
+    }
+}
+
+int main()
+{
+    testTouchBeyondCollinearRun();
+    testJointOnCollinearLine();
+    testFoldBack();
+    testRandomWalks();
+    testOrientation();
+
+    if (failures > 0)
+    {
+        cout << failures << " failures." << endl;
+        return 1;
+    }
+
+    cout << "All tests passed." << endl;
+    return 0;
+}